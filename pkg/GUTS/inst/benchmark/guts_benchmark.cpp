@@ -0,0 +1,264 @@
+/**
+ * GUTS: Fast Calculation of the Likelihood of a Stochastic Survival Model.
+ * Benchmark of the GUTS engines without R
+ * soeren.vogel@posteo.ch, carlo.albert@eawag.ch, alexander singer@rifcon.de, oliver.jakoby@rifcon.de, dirk.nickisch@rifcon.de
+ * License GPL-2
+ * 2026-10-19
+ */
+
+/**
+ * Runs each combination of model and threshold distribution of guts_engine on synthetic
+ * exposure profiles (constant or pulsed) of several lengths, with several time steps M and
+ * threshold bins N. Projections use the projectors on std::vector (see make_guts_evaluator).
+ * Each case runs in a child process (POSIX), such that the peak memory is that of the case.
+ *
+ * Output: one CSV line per case on stdout:
+ *   engine, model, dist, profile, days, pulses, M, N, evaluations, seconds_per_evaluation,
+ *   steps_per_second, peak_rss_kb, loglikelihood
+ * steps: time steps of models SD and proper (M per evaluation), concentration intervals of model IT.
+ * peak_rss_kb: peak resident memory of the case (NA without POSIX).
+ *
+ * Usage: guts_benchmark [--quick] [--engine=<name>] [--min-time=<seconds>]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "guts_native.h"
+#include <GUTS/samplers.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define GUTS_BENCHMARK_POSIX
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+typedef std::vector<double > nvec;
+
+namespace {
+
+struct engine {
+  const char* name;
+  TD_type model;
+  dist_type dist;
+  ///parameters as used by guts_calc_loglikelihood
+  nvec par;
+};
+
+const std::vector<engine > engines = {
+  {"IT_loglogistic", TD_type::IT, dist_type::LOGLOGISTIC, {0.01, 0.5, 4.0, 3.0}},
+  {"IT_lognormal", TD_type::IT, dist_type::LOGNORMAL, {0.01, 0.5, 4.0, 2.0}},
+  {"IT_external", TD_type::IT, dist_type::EXTERNAL, {0.01, 0.5}},
+  {"SD", TD_type::SD, dist_type::DELTA, {0.01, 0.5, 0.5, 4.0}},
+  {"proper_loglogistic", TD_type::PROPER, dist_type::LOGLOGISTIC, {0.01, 0.5, 0.5, 4.0, 3.0}},
+  {"proper_lognormal", TD_type::PROPER, dist_type::LOGNORMAL, {0.01, 0.5, 0.5, 4.0, 2.0}},
+  {"proper_delta", TD_type::PROPER, dist_type::DELTA, {0.01, 0.5, 0.5, 4.0}},
+  {"proper_external", TD_type::PROPER, dist_type::EXTERNAL, {0.01, 0.5, 0.5}}
+};
+
+const char* model_name(const TD_type model) {
+  switch (model) {
+  case TD_type::IT : return "IT";
+  case TD_type::SD : return "SD";
+  case TD_type::PROPER : return "Proper";
+  }
+  return "";
+}
+
+const char* dist_name(const dist_type dist) {
+  switch (dist) {
+  case dist_type::LOGLOGISTIC : return "loglogistic";
+  case dist_type::LOGNORMAL : return "lognormal";
+  case dist_type::DELTA : return "delta";
+  case dist_type::EXTERNAL : return "external";
+  }
+  return "";
+}
+
+struct benchmark_case {
+  const engine* eng;
+  double days;
+  ///number of pulses; 0: constant exposure
+  std::size_t pulses;
+  std::size_t M;
+  std::size_t N;
+};
+
+/**
+ * \brief Constant exposure, or pulses of one day spread evenly over the profile
+ * \details Pulses rise and fall within 0.05 days. Survival is observed daily;
+ * survivors decline smoothly from 100.
+ */
+guts_native_data make_data(const benchmark_case& c) {
+  const double C0 = 8.0;
+  guts_native_data data;
+  if (c.pulses == 0) {
+    data.Ct = {0.0, c.days};
+    data.C = {C0, C0};
+  } else {
+    const double spacing = c.days / static_cast<double >(c.pulses);
+    const double width = std::min(1.0, 0.5 * spacing);
+    const double edge = std::min(0.05, 0.25 * width);
+    data.Ct.push_back(0.0);
+    data.C.push_back(0.0);
+    for (std::size_t i = 0; i < c.pulses; ++i) {
+      const double start = spacing * (static_cast<double >(i) + 0.25);
+      for (const double t : {start, start + edge, start + width - edge, start + width}) data.Ct.push_back(t);
+      for (const double C : {0.0, C0, C0, 0.0}) data.C.push_back(C);
+    }
+    data.Ct.push_back(c.days);
+    data.C.push_back(0.0);
+  }
+  const std::size_t n_days = static_cast<std::size_t >(c.days);
+  for (std::size_t i = 0; i <= n_days; ++i) {
+    data.yt.push_back(static_cast<double >(i));
+    data.y.push_back(static_cast<int >(std::lround(100.0 * std::exp(-1.5 * static_cast<double >(i) / c.days))));
+  }
+  data.M = c.M;
+  data.N = c.N;
+  data.SVR = 1.0;
+  data.model = c.eng->model;
+  data.dist = c.eng->dist;
+  data.log_survival = false;
+  data.single_precision = false;
+  data.quadrature = false;
+  data.trapezoid = false;
+  if (data.dist == dist_type::EXTERNAL) {
+    // lognormal quantiles (median 4, sdlog 0.5), sorted
+    for (std::size_t i = 0; i < c.N; ++i) {
+      const double p = (static_cast<double >(i) + 0.5) / static_cast<double >(c.N);
+      data.z_dist.push_back(4.0 * std::exp(0.5 * normal_quantile(p)));
+    }
+  }
+  return data;
+}
+
+struct benchmark_result {
+  std::size_t evaluations;
+  double seconds;
+  double steps;
+  double loglikelihood;
+};
+
+/**
+ * \brief Evaluate parameters until min_time has passed
+ * \details The dominant rate constant changes with each evaluation, such that damage
+ * is not reused from the previous projection. The reported loglikelihood is evaluated
+ * once more at the nominal parameters, after timing.
+ */
+benchmark_result run_case(const benchmark_case& c, const double min_time) {
+  const guts_native_data data = make_data(c);
+  std::unique_ptr<guts_evaluator > evaluator = make_guts_evaluator(data);
+  nvec par = c.eng->par;
+  const double kd = par[1];
+  benchmark_result result = {0, 0.0, 0.0, 0.0};
+  const double steps_per_evaluation = c.eng->model == TD_type::IT ?
+    static_cast<double >(data.Ct.size() - 1) : static_cast<double >(c.M);
+  const auto start = std::chrono::steady_clock::now();
+  do {
+    for (std::size_t i = 0; i < 8; ++i, ++result.evaluations) {
+      par[1] = kd * (1.0 + 1e-6 * static_cast<double >(result.evaluations % 1000));
+      result.loglikelihood = evaluator->calc_loglikelihood(par);
+    }
+    result.seconds = std::chrono::duration<double >(std::chrono::steady_clock::now() - start).count();
+  } while (result.seconds < min_time);
+  result.steps = steps_per_evaluation * static_cast<double >(result.evaluations);
+  result.loglikelihood = evaluator->calc_loglikelihood(c.eng->par);
+  return result;
+}
+
+std::string format_result(const benchmark_case& c, const benchmark_result& r, const long peak_rss_kb) {
+  char line[512];
+  std::snprintf(line, sizeof(line), "%s,%s,%s,%s,%g,%zu,%zu,%zu,%zu,%.6e,%.6e,%s,%.10g\n",
+    c.eng->name, model_name(c.eng->model), dist_name(c.eng->dist),
+    c.pulses == 0 ? "constant" : "pulsed", c.days, c.pulses, c.M, c.N,
+    r.evaluations, r.seconds / static_cast<double >(r.evaluations), r.steps / r.seconds,
+    peak_rss_kb < 0 ? "NA" : std::to_string(peak_rss_kb).c_str(), r.loglikelihood);
+  return line;
+}
+
+/**
+ * \brief Run a case and print its line; in a child process if available
+ */
+void run_and_print(const benchmark_case& c, const double min_time) {
+#ifdef GUTS_BENCHMARK_POSIX
+  std::fflush(stdout);
+  const pid_t pid = fork();
+  if (pid == 0) {
+    const benchmark_result r = run_case(c, min_time);
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    const long peak_rss_kb = usage.ru_maxrss / 1024;
+#else
+    const long peak_rss_kb = usage.ru_maxrss;
+#endif
+    std::fputs(format_result(c, r, peak_rss_kb).c_str(), stdout);
+    std::fflush(stdout);
+    _exit(0);
+  }
+  if (pid > 0) {
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      std::fprintf(stderr, "case %s M = %zu N = %zu failed\n", c.eng->name, c.M, c.N);
+    }
+    return;
+  }
+#endif
+  std::fputs(format_result(c, run_case(c, min_time), -1).c_str(), stdout);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  bool quick = false;
+  std::string engine_filter;
+  double min_time = 0.2;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--quick") == 0) {
+      quick = true;
+    } else if (std::strncmp(argv[i], "--engine=", 9) == 0) {
+      engine_filter = argv[i] + 9;
+    } else if (std::strncmp(argv[i], "--min-time=", 11) == 0) {
+      min_time = std::atof(argv[i] + 11);
+    } else {
+      std::fprintf(stderr, "usage: %s [--quick] [--engine=<name>] [--min-time=<seconds>]\n", argv[0]);
+      return 1;
+    }
+  }
+  const std::vector<double > days = quick ? std::vector<double >{7} : std::vector<double >{7, 28, 365};
+  const std::vector<std::size_t > pulses = quick ? std::vector<std::size_t >{0, 3} : std::vector<std::size_t >{0, 4, 52};
+  const std::vector<std::size_t > Ms = quick ? std::vector<std::size_t >{1000} : std::vector<std::size_t >{1000, 10000, 100000};
+  const std::vector<std::size_t > Ns = quick ? std::vector<std::size_t >{100} : std::vector<std::size_t >{100, 1000, 10000};
+
+  std::printf("engine,model,dist,profile,days,pulses,M,N,evaluations,seconds_per_evaluation,steps_per_second,peak_rss_kb,loglikelihood\n");
+  for (const engine& eng : engines) {
+    if (!engine_filter.empty() && engine_filter != eng.name) continue;
+    // M is used by SD and proper models, N by proper models with parametric distributions;
+    // the size of external distributions is N
+    const bool uses_M = eng.model != TD_type::IT;
+    const bool uses_N = eng.dist == dist_type::EXTERNAL ||
+      (eng.model == TD_type::PROPER && eng.dist != dist_type::DELTA);
+    for (const double d : days) {
+      for (const std::size_t p : pulses) {
+        // pulses of at most one day, at least two days apart
+        if (p > 0 && 2 * p > d) continue;
+        for (const std::size_t M : uses_M ? Ms : std::vector<std::size_t >{Ms.front()}) {
+          for (const std::size_t N : uses_N ? Ns : std::vector<std::size_t >{Ns.front()}) {
+            run_and_print(benchmark_case{&eng, d, p, M, N}, min_time);
+          }
+        }
+      }
+    }
+  }
+  return 0;
+}
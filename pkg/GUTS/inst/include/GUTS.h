@@ -0,0 +1,42 @@
+/**
+ * GUTS: Fast Calculation of the Likelihood of a Stochastic Survival Model.
+ * soeren.vogel@posteo.ch, carlo.albert@eawag.ch, alexander singer@rifcon.de, oliver.jakoby@rifcon.de, dirk.nickisch@rifcon.de
+ * License GPL-2
+ * 2026-10-19
+ */
+
+/**
+ * Header-only C++ interface to the GUTS-RED models for packages with "LinkingTo: GUTS".
+ * The headers do not depend on R or Rcpp. Instrumentation (GUTS_INSTRUMENT) needs the package library
+ * and must not be defined by other packages.
+ *
+ * Example: loglikelihood of model SD, parameters (hb, kd, kk, z)
+ *
+ *   #include <GUTS.h>
+ *   typedef std::vector<double > nvec;
+ *   typedef guts_projector<guts_RED<nvec, nvec, TD_SD, nvec >, nvec, nvec > SD_projector;
+ *
+ *   external_data<nvec, nvec, true, false > data; // time-discrete, no threshold sample size
+ *   data.set_data(Ct, C, yt, M, 1.0);
+ *   SD_projector projector;
+ *   projector.initialize(data);
+ *   const nvec p = project(projector, nvec{hb, kd, kk, z});
+ *   const double LL = calculate_loglikelihood(p, y);
+ *
+ * Projectors of other models:
+ *   IT: guts_projector_fastIT<guts_RED<nvec, nvec, TD_IT_loglogistic, nvec >, nvec, nvec >
+ *       (or TD_IT_lognormal, TD<random_sample<nvec >, 'I' >), data external_data<nvec, nvec, false, false >
+ *   Proper: guts_projector<guts_RED<nvec, nvec, TD_proper_loglogistic, nvec >, nvec, nvec >
+ *       (or TD_proper_lognormal, TD_proper_delta, TD<random_sample<nvec >, 'P' >),
+ *       data external_data<nvec, nvec, true, true > for parametric distributions with sample size N
+ * Parameters have 5 positions (hb, kd, kk, threshold parameter 1, threshold parameter 2); unused positions
+ * are ignored. try_project() and try_project_loglikelihood() report numerical failures as guts_status.
+ */
+
+#ifndef GUTS_H
+#define GUTS_H
+
+#include "GUTS/GUTS_RED.h"
+#include "GUTS/external_data.h"
+
+#endif //GUTS_H
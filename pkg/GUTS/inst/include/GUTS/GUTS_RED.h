@@ -6,6 +6,7 @@
  * updated: 2019-01-29
  * updated: 2021-11-30 
  * updated: 2022-01-17
+ * updated: 2026-10-19
  */
 
 #ifndef GUTS_RED_H
@@ -21,9 +22,9 @@
 
 template<typename tt, typename tc, typename TD_mod, typename tparam >
 struct guts_RED_base :
-  public guts_model<TK_RED<tt, tc >, TD_mod >
+  public guts_model<TK_RED<tt, tc, typename TD_mod::scalar_type >, TD_mod >
 {
-  typedef TK_RED<tt, tc > TK_mod;
+  typedef TK_RED<tt, tc, typename TD_mod::scalar_type > TK_mod;
   enum class position : std::size_t {hb = 0, kd = 1, kk = 2, t1 = 3, t2 = 4};
   
   virtual tparam  get_parameters() const = 0;
@@ -83,10 +84,10 @@ struct guts_RED
   guts_RED() = delete;
 };
 
-template<typename tt, typename tC, typename tparam >
-struct guts_RED<tt, tC, TD_proper_lognormal, tparam > :
-  public guts_RED_base<tt, tC, TD_proper_lognormal, tparam  > {
-  typedef TD_proper_lognormal TD_mod;
+template<typename tt, typename tC, typename lognormal_sampler, typename tparam >
+struct guts_RED_proper_lognormal :
+  public guts_RED_base<tt, tC, TD<lognormal_sampler, 'P' >, tparam  > {
+  typedef TD<lognormal_sampler, 'P' > TD_mod;
   tparam get_parameters() const override {
     tparam param(5);
     get_parameters_hb_kd(*this, param);
@@ -101,10 +102,20 @@ struct guts_RED<tt, tC, TD_proper_lognormal, tparam > :
   }
 };
 
-template<typename tt, typename tC, typename tparam >
-struct guts_RED<tt, tC, TD_proper_loglogistic, tparam > :
-  public guts_RED_base<tt, tC, TD_proper_loglogistic, tparam  > {
-  typedef TD_proper_loglogistic TD_mod;
+template<typename tt, typename tC, typename tScalar, typename tparam >
+struct guts_RED<tt, tC, TD_proper_lognormal_scalar<tScalar >, tparam > :
+  public guts_RED_proper_lognormal<tt, tC, basic_imp_lognormal<tScalar >, tparam  > {
+};
+
+template<typename tt, typename tC, typename tScalar, typename tparam >
+struct guts_RED<tt, tC, TD_proper_quad_lognormal_scalar<tScalar >, tparam > :
+  public guts_RED_proper_lognormal<tt, tC, basic_quad_lognormal<tScalar >, tparam  > {
+};
+
+template<typename tt, typename tC, typename loglogistic_sampler, typename tparam >
+struct guts_RED_proper_loglogistic :
+  public guts_RED_base<tt, tC, TD<loglogistic_sampler, 'P' >, tparam  > {
+  typedef TD<loglogistic_sampler, 'P' > TD_mod;
   tparam get_parameters() const override {
     tparam param(5);
     get_parameters_hb_kd(*this, param);
@@ -119,10 +130,20 @@ struct guts_RED<tt, tC, TD_proper_loglogistic, tparam > :
   }
 };
 
-template<typename tt, typename tC, typename tparam >
-struct guts_RED<tt, tC, TD_proper_delta, tparam  > :
-  public guts_RED_base<tt, tC, TD_proper_delta, tparam  > {
-  typedef TD_proper_delta TD_mod;
+template<typename tt, typename tC, typename tScalar, typename tparam >
+struct guts_RED<tt, tC, TD_proper_loglogistic_scalar<tScalar >, tparam > :
+  public guts_RED_proper_loglogistic<tt, tC, basic_imp_loglogistic<tScalar >, tparam  > {
+};
+
+template<typename tt, typename tC, typename tScalar, typename tparam >
+struct guts_RED<tt, tC, TD_proper_quad_loglogistic_scalar<tScalar >, tparam > :
+  public guts_RED_proper_loglogistic<tt, tC, basic_quad_loglogistic<tScalar >, tparam  > {
+};
+
+template<typename tt, typename tC, typename tScalar, typename tparam >
+struct guts_RED<tt, tC, TD_proper_delta_scalar<tScalar >, tparam  > :
+  public guts_RED_base<tt, tC, TD_proper_delta_scalar<tScalar >, tparam  > {
+  typedef TD_proper_delta_scalar<tScalar > TD_mod;
   tparam get_parameters() const override {
     tparam param(5);
     get_parameters_hb_kd(*this, param);
@@ -137,10 +158,10 @@ struct guts_RED<tt, tC, TD_proper_delta, tparam  > :
   }
 };
 
-template<typename tt, typename tC, typename tparam >
-struct guts_RED<tt, tC, TD<random_sample<tparam >, 'P' >, tparam > :
-	public guts_RED_base<tt, tC, TD<random_sample<tparam >, 'P' >, tparam  > {
-	typedef TD<random_sample<tparam >, 'P' > TD_mod;
+template<typename tt, typename tC, typename tz, typename tparam >
+struct guts_RED<tt, tC, TD<random_sample<tz >, 'P' >, tparam > :
+	public guts_RED_base<tt, tC, TD<random_sample<tz >, 'P' >, tparam  > {
+	typedef TD<random_sample<tz >, 'P' > TD_mod;
 	tparam get_parameters() const override {
 		tparam param(3);
 		get_parameters_hb_kd(*this, param);
@@ -154,10 +175,10 @@ struct guts_RED<tt, tC, TD<random_sample<tparam >, 'P' >, tparam > :
 	}
 };
 
-template<typename tt, typename tC, typename tparam >
-struct guts_RED<tt, tC, TD_SD, tparam  > :
-  public guts_RED_base<tt, tC, TD_SD, tparam  > {
-  typedef TD_SD TD_mod;
+template<typename tt, typename tC, typename tScalar, typename tparam >
+struct guts_RED<tt, tC, TD_SD_scalar<tScalar >, tparam  > :
+  public guts_RED_base<tt, tC, TD_SD_scalar<tScalar >, tparam  > {
+  typedef TD_SD_scalar<tScalar > TD_mod;
   tparam get_parameters() const override {
     tparam param(5);
     get_parameters_hb_kd(*this, param);
@@ -198,6 +219,11 @@ struct guts_RED<tt, tC, TD_IT_imp_lognormal, tparam > :
   public guts_RED_IT_lognormal<tt, tC, imp_lognormal, tparam  > {
 };
 
+template<typename tt, typename tC, typename tparam >
+struct guts_RED<tt, tC, TD_IT_quad_lognormal, tparam > :
+  public guts_RED_IT_lognormal<tt, tC, quad_lognormal, tparam  > {
+};
+
 template<typename tt, typename tC, typename loglogistic_sampler, typename tparam >
 struct guts_RED_IT_loglogistic :
   public guts_RED_base<tt, tC, TD<loglogistic_sampler, 'I' >, tparam  > {
@@ -224,6 +250,11 @@ struct guts_RED<tt, tC, TD_IT_imp_loglogistic, tparam > :
   public guts_RED_IT_loglogistic<tt, tC, imp_loglogistic, tparam  > {
 };
 
+template<typename tt, typename tC, typename tparam >
+struct guts_RED<tt, tC, TD_IT_quad_loglogistic, tparam > :
+  public guts_RED_IT_loglogistic<tt, tC, quad_loglogistic, tparam  > {
+};
+
 template<typename tt, typename tC, typename tparam >
 struct guts_RED<tt, tC, TD<random_sample<tparam >, 'I' >, tparam > :
 	public guts_RED_base<tt, tC, TD<random_sample<tparam >, 'I' >, tparam  > {
@@ -252,4 +283,47 @@ typename tProjector::tProjection project(
   return result;
 }
 
+/**
+ * \brief Project survival without throwing on numerical failures
+ * \details Parameters are checked before the projection. On failure the projection
+ * is stopped and the reason is returned. The survival projection can then be
+ * retrieved via get_survival_projection().
+ * \returns guts_status::ok on success
+ */
+template<typename tProjector, typename tParameters >
+guts_status try_project(
+    tProjector& projector,
+    const tParameters& parameters) {
+  projector.set_parameters(parameters);
+  const guts_status status = projector.check_parameters();
+  if (status != guts_status::ok) return status;
+  projector.initialize_from_parameters();
+  projector.set_start_conditions();
+  return projector.try_project_survival();
+}
+
+/**
+ * \brief Project survival and calculate the loglikelihood, stop early below a lower bound
+ * \details See guts_projector_base::try_project_loglikelihood.
+ * With parameters of dual numbers, loglik holds the loglikelihood and its derivatives.
+ * \returns guts_status::ok on success
+ */
+template<typename tProjector, typename tParameters, typename tmeasured_survivors, typename tLoglik >
+guts_status try_project_loglikelihood(
+    tProjector& projector,
+    const tParameters& parameters,
+    const tmeasured_survivors& y,
+    const double lower_bound,
+    tLoglik& loglik,
+    bool& rejected) {
+  projector.set_parameters(parameters);
+  rejected = false;
+  loglik = -std::numeric_limits<double >::infinity();
+  const guts_status status = projector.check_parameters();
+  if (status != guts_status::ok) return status;
+  projector.initialize_from_parameters();
+  projector.set_start_conditions();
+  return projector.try_project_loglikelihood(y, lower_bound, loglik, rejected);
+}
+
 #endif //GUTS_TD_H
@@ -0,0 +1,585 @@
+/**
+ * GUTS: Fast Calculation of the Likelihood of a Stochastic Survival Model.
+ * soeren.vogel@posteo.ch, carlo.albert@eawag.ch, alexander singer@rifcon.de, oliver.jakoby@rifcon.de, dirk.nickisch@rifcon.de
+ * License GPL-2
+ * 2017-10-09 
+ * updated: 2019-01-29
+ * updated: 2021-11-30
+ * updated: 2022-01-17 
+ * updated: 2026-10-19
+ */
+
+#ifndef GUTS_BASE_H_
+#define GUTS_BASE_H_
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+
+#include "helpers.h"
+#include "guts_dual.h"
+#include "guts_instrument.h"
+#include "guts_status.h"
+
+/** 
+ * \brief Defines the public combination of a TK and a TD object 
+ * \tparam TK Type of TK model
+ * \tparam TD Type of TD model
+ * \tparam tData object with model relevant data
+ * \detail This generic definition should be parent of any guts_model
+ */
+template<typename TK_mod, typename TD_mod >
+struct guts_model: 
+  virtual public TK_mod, virtual public TD_mod {
+  ///numeric type of damage and survival
+  typedef typename TD_mod::scalar_type scalar_type;
+  virtual ~guts_model() {};
+  template<typename tData >
+  inline void initialize(const tData& data) {
+    TK_mod::initialize(data);
+    TD_mod::initialize(data);
+  }
+  void initialize_from_parameters() override {
+  	TK_mod::initialize_from_parameters();
+  	TD_mod::initialize_from_parameters();
+  	}
+  void set_start_conditions() const override {
+    TK_mod::set_start_conditions();
+    TD_mod::set_start_conditions();
+  }
+  guts_model() : TK_mod(), TD_mod() {}
+};
+
+/**
+ * @brief loglikelihood of observed survivors given a survival projection
+ * @details The result has the numeric type of the projection, e.g. dual numbers
+ * if derivatives with respect to parameters are propagated.
+ * @param[in] p survival projection
+ * @param[in] y observed survivors
+ */
+template<typename tProjection, typename tmeasured_survivors,
+  typename tScalar = typename std::decay<decltype(back(std::declval<const tProjection& >()))>::type >
+  tScalar calculate_loglikelihood(const tProjection& p, const tmeasured_survivors& y) {
+    using std::log;
+    std::size_t diffy;
+    tScalar diffS;
+    tScalar loglik;
+    if (back(y) > 0) {
+      if (back(p) == 0.0) {
+        return -std::numeric_limits<double >::infinity(); 
+      } else {
+        loglik = back(y) * log(back(p));
+      }
+    } else {
+      loglik = 0;
+    }
+    for (std::size_t i=1; i < y.size(); ++i ) {
+      diffy = y.at(i-1) - y.at(i);
+      if (diffy > 0) {
+        diffS = p.at(i-1) - p.at(i);
+        if (diffS == 0.0) {
+          return -std::numeric_limits<double >::infinity();
+        }
+        loglik += static_cast<double>(diffy) * log(diffS);
+      }
+    } 
+    return loglik;
+  }
+
+/**
+ * @brief loglikelihood from survival probabilities in log-space
+ * @details Equivalent to calculate_loglikelihood(), but the differences of
+ * survival probabilities are evaluated as log(p[i-1]) + log(1 - p[i]/p[i-1]),
+ * which remains finite when p underflows.
+ * @param[in] logp logarithm of the survival projection
+ * @param[in] y observed survivors
+ */
+template<typename tProjection, typename tmeasured_survivors,
+  typename tScalar = typename std::decay<decltype(back(std::declval<const tProjection& >()))>::type >
+  tScalar calculate_loglikelihood_from_log_survival(const tProjection& logp, const tmeasured_survivors& y) {
+    using std::exp;
+    using std::log1p;
+    std::size_t diffy;
+    tScalar loglik;
+    if (back(y) > 0) {
+      if (back(logp) == -std::numeric_limits<double >::infinity()) {
+        return -std::numeric_limits<double >::infinity(); 
+      } else {
+        loglik = back(y) * back(logp);
+      }
+    } else {
+      loglik = 0;
+    }
+    for (std::size_t i=1; i < y.size(); ++i ) {
+      diffy = y.at(i-1) - y.at(i);
+      if (diffy > 0) {
+        if (logp.at(i) == logp.at(i-1)) {
+          return -std::numeric_limits<double >::infinity();
+        }
+        loglik += static_cast<double>(diffy) * (logp.at(i-1) + log1p(-exp(logp.at(i) - logp.at(i-1))));
+      }
+    } 
+    return loglik;
+  }
+
+/**
+ * \brief Observer of a survival projection that never stops the projection
+ */
+struct projection_without_stop {
+  inline bool stop(const std::size_t, const double, const double) {return false;}
+};
+
+/**
+ * \brief Observer of a survival projection that accumulates the loglikelihood
+ * \details All summands of the loglikelihood are non-positive. After each
+ * survival measurement time, the partial loglikelihood plus the term of the
+ * survivors at the end (evaluated at the current survival) is an upper bound of the
+ * final loglikelihood. The projection stops, once this bound falls below lower_bound.
+ * \tparam tmeasured_survivors type of the observed survivors
+ */
+template<typename tmeasured_survivors >
+struct loglikelihood_bound {
+  loglikelihood_bound(const tmeasured_survivors& new_y, const double new_lower_bound, const bool new_log_scale) :
+    y(new_y), lower_bound(new_lower_bound), log_scale(new_log_scale), loglik(0.0), rejected(false) {}
+  /**
+   * \param[in] ytpos index of the survival measurement
+   * \param[in] previous survival (or log survival) at ytpos - 1
+   * \param[in] current survival (or log survival) at ytpos
+   * \returns true if the loglikelihood cannot reach lower_bound any more
+   */
+  inline bool stop(const std::size_t ytpos, const double previous, const double current) {
+    const double logp_previous = log_scale ? previous : std::log(previous);
+    const double logp_current = log_scale ? current : std::log(current);
+    const std::size_t diffy = y.at(ytpos-1) - y.at(ytpos);
+    if (diffy > 0) {
+      if (logp_current == logp_previous) {
+        loglik = -std::numeric_limits<double >::infinity();
+        rejected = true;
+        return true;
+      }
+      loglik += static_cast<double>(diffy) * (logp_previous + std::log1p(-std::exp(logp_current - logp_previous)));
+    }
+    const double upper_bound = back(y) > 0 ? loglik + back(y) * logp_current : loglik;
+    if (upper_bound < lower_bound) {
+      loglik = upper_bound;
+      rejected = true;
+    }
+    return rejected;
+  }
+  const tmeasured_survivors& y;
+  const double lower_bound;
+  const bool log_scale;
+  ///partial loglikelihood; an upper bound of the loglikelihood, if rejected
+  double loglik;
+  ///true if the projection was stopped early
+  bool rejected;
+};
+
+template<typename tModel, typename tt, typename tSurvival >
+struct guts_projector_base : public tModel {
+  typedef tSurvival tProjection;
+  guts_projector_base() : tModel(), trapezoid(false), log_survival(false) {}
+  virtual ~guts_projector_base() {}
+  inline void set_start_conditions() const override {
+  	tModel::set_start_conditions();
+  }
+  inline void get_survival_projection(tProjection& proj) const {proj = p;}
+  /**
+   * @brief copy the logarithm of the survival projection
+   * @details Only available if survival is tracked in log-space (see set_log_survival(bool)).
+   */
+  inline void get_log_survival_projection(tProjection& proj) const {proj = logp;}
+  /**
+   * @brief track survival in log-space
+   * @details If true, survival probabilities are accumulated as logarithms,
+   * which avoids numeric underflow for very low survival.
+   */
+  inline void set_log_survival(const bool new_log_survival) {log_survival = new_log_survival;}
+  inline bool is_log_survival() const {return log_survival;}
+  /**
+   * @brief integrate the hazard of time-discrete projections with the trapezoidal rule
+   * @details If true, guts_projector corrects the rectangle rule of the TD to the trapezoidal rule
+   * at each survival time (see TD_base::set_trapezoid_end), and damage continues from its exact value
+   * at each concentration measurement time. The error is O(dtau^2) instead of O(dtau).
+   * guts_projector_fastIT evaluates damage at the survival times and ignores this setting.
+   * Set before the first projection.
+   */
+  inline void set_trapezoid(const bool new_trapezoid) {trapezoid = new_trapezoid;}
+  inline bool is_trapezoid() const {return trapezoid;}
+  void project_survival () const {
+    throw_on_status(try_project_survival());
+  }
+  /**
+   * @brief project survival without throwing on numerical failures
+   * @returns guts_status::ok on success, the reason of the failure otherwise
+   */
+  guts_status try_project_survival () const {
+    projection_without_stop observer;
+    return log_survival ? project_log_survival(observer) : project_survival(observer);
+  }
+  /**
+   * @brief project survival and calculate the loglikelihood, stop early if the loglikelihood drops below a bound
+   * @details The loglikelihood is accumulated after each survival measurement time. 
+   * If it cannot reach lower_bound any more, the projection is stopped, rejected is set true
+   * and loglik holds an upper bound of the loglikelihood (below lower_bound).
+   * Otherwise loglik is the loglikelihood of the complete projection.
+   * @param[in] y observed survivors
+   * @param[in] lower_bound e.g. the acceptance threshold log(u) + LL_current in Metropolis-Hastings
+   * @param[out] loglik the loglikelihood (or its upper bound, if rejected)
+   * @param[out] rejected true, if the projection was stopped early
+   * @returns guts_status::ok on success, the reason of the failure otherwise
+   */
+  template<typename tmeasured_survivors, typename tLoglik >
+  guts_status try_project_loglikelihood (
+      const tmeasured_survivors& y,
+      const double lower_bound,
+      tLoglik& loglik,
+      bool& rejected
+  ) const {
+    loglikelihood_bound<tmeasured_survivors > observer(y, lower_bound, log_survival);
+    const guts_status status = log_survival ? project_log_survival(observer) : project_survival(observer);
+    rejected = observer.rejected;
+    if (status != guts_status::ok) {
+      loglik = -std::numeric_limits<double >::infinity();
+    } else if (rejected) {
+      loglik = observer.loglik;
+    } else {
+      GUTS_INSTRUMENT_SCOPE(loglikelihood);
+      loglik = log_survival ?
+        calculate_loglikelihood_from_log_survival(logp, y) :
+        calculate_loglikelihood(p, y);
+    }
+    return status;
+  }
+  virtual std::vector<double > get_damage() const = 0;
+  virtual std::vector<double > get_damage_time() const = 0;
+  template<typename tData >
+  inline void initialize(const tData& data) {
+    GUTS_INSTRUMENT_COUNT(allocations, 1);
+    yt = data.yt;
+    p.assign(yt->size(), std::numeric_limits<double>::quiet_NaN());
+    tModel::initialize(data);
+  }
+  //tData exp_dat;
+protected:
+  std::shared_ptr<const tt > yt;
+  virtual void gather_effect_per_time_step(const double, const double) const = 0;
+  bool trapezoid;
+private:
+  mutable tSurvival p;
+  mutable tSurvival logp;
+  bool log_survival;
+  template<typename tObserver >
+  guts_status project_survival (tObserver& observer) const {
+    p.assign(yt->size(), 0);
+    
+    {
+      GUTS_INSTRUMENT_SCOPE(survival);
+      GUTS_INSTRUMENT_COUNT(survival, 1);
+      p.at(0) = tModel::TD_mod::calculate_current_survival(0);
+    }
+    if ( p.at(0) <= 0.0 ) {
+      // should never happen with well defined parameters
+      return guts_status::survival_underflow;
+    }
+    std::size_t ytpos = 1; //index yt
+    while (ytpos < yt->size() && p.at(ytpos-1) > 0) {
+      tModel::TD_mod::update_to_next_survival_measurement();
+      {
+        GUTS_INSTRUMENT_SCOPE(projection);
+        gather_effect_per_time_step(yt->at(ytpos), yt->at(ytpos-1));
+      }
+      {
+        GUTS_INSTRUMENT_SCOPE(survival);
+        GUTS_INSTRUMENT_COUNT(survival, 1);
+        p.at(ytpos) = tModel::TD_mod::calculate_current_survival(yt->at(ytpos)) / p.at(0);
+      }
+      if (observer.stop(ytpos, ytpos == 1 ? 1.0 : value_of(p.at(ytpos-1)), value_of(p.at(ytpos)))) break;
+      ++ytpos;
+    }
+    p.at(0) = 1;
+    return guts_status::ok;
+  }
+  template<typename tObserver >
+  guts_status project_log_survival (tObserver& observer) const {
+    logp.assign(yt->size(), -std::numeric_limits<double>::infinity());
+    
+    GUTS_INSTRUMENT_COUNT(survival, 1);
+    const auto logp0 = tModel::TD_mod::calculate_current_log_survival(0);
+    if ( logp0 == -std::numeric_limits<double>::infinity() ) {
+      return guts_status::survival_underflow;
+    }
+    logp.at(0) = 0;
+    std::size_t ytpos = 1; //index yt
+    while (ytpos < yt->size() && logp.at(ytpos-1) > -std::numeric_limits<double>::infinity()) {
+      tModel::TD_mod::update_to_next_survival_measurement();
+      {
+        GUTS_INSTRUMENT_SCOPE(projection);
+        gather_effect_per_time_step(yt->at(ytpos), yt->at(ytpos-1));
+      }
+      {
+        GUTS_INSTRUMENT_SCOPE(survival);
+        GUTS_INSTRUMENT_COUNT(survival, 1);
+        logp.at(ytpos) = tModel::TD_mod::calculate_current_log_survival(yt->at(ytpos)) - logp0;
+      }
+      if (observer.stop(ytpos, value_of(logp.at(ytpos-1)), value_of(logp.at(ytpos)))) break;
+      ++ytpos;
+    }
+    using std::exp;
+    p.assign(yt->size(), 0);
+    for (std::size_t i = 0; i < logp.size(); ++i) p[i] = exp(logp[i]);
+    return guts_status::ok;
+  }
+};
+
+template<typename tModel, typename tt, typename tSurvival >
+struct guts_projector: public guts_projector_base<tModel, tt, tSurvival > {
+public:
+	typedef tSurvival tProjection;
+	typedef guts_projector_base<tModel, tt, tSurvival > parent;
+	typedef typename tModel::scalar_type scalar_type;
+	guts_projector() : parent(), damage_cache_size(0),
+		damage_cache_ke(std::numeric_limits<double>::quiet_NaN()) {}
+	virtual ~guts_projector() {}
+	template<typename tData >
+	inline void initialize(const tData& data) {
+	  M = data.M;
+	  dtau = data.calculate_dtau(); 
+	  GUTS_INSTRUMENT_COUNT(allocations, 2);
+	  damage_cache.assign(M, scalar_type());
+	  damage_cache_size = 0;
+	  damage_Ct.assign(data.Ct->size(), scalar_type());
+	  parent::initialize(data);
+	}
+	/**
+	 * @details Damage depends on the data and the dominant rate constant only. If the rate constant
+	 * did not change since the previous projection, damage is taken from that projection
+	 * (e.g. while optimizing or sampling the other parameters).
+	 */
+	inline void set_start_conditions() const override {
+		tauit = 0; //index discrete time
+		k = 0;     //index Ct
+		damage_Ct[0] = 0.0;
+		D.assign(M, std::numeric_limits<double>::quiet_NaN());
+		const double ke = value_of(tModel::TK_mod::get_dominant_rate_constant());
+		if ( !(ke == damage_cache_ke) ) {
+			damage_cache_size = 0;
+			damage_cache_ke = ke;
+		}
+		parent::set_start_conditions();
+	}
+	std::vector<double > get_damage() const override {return D;}
+	std::vector<double > get_damage_time() const override {
+		std::vector<double > damage_time(M, std::numeric_limits<double>::quiet_NaN());
+		damage_time[0] = 0;
+		for (
+				std::vector<double >::iterator it = damage_time.begin() + 1; 
+      it != damage_time.begin() + tauit;
+      ++it) { 
+       *it = *(it-1) + dtau;
+		}
+		return damage_time;
+	}
+protected:
+	std::size_t M;
+	double dtau;
+	mutable std::vector<double > D;
+private:
+	mutable std::size_t tauit; //index discrete time
+	mutable std::size_t k;     //index Ct
+	///damage of the previous projections with the same dominant rate constant
+	mutable std::vector<scalar_type > damage_cache;
+	///number of valid values in damage_cache
+	mutable std::size_t damage_cache_size;
+	///dominant rate constant of damage_cache
+	mutable double damage_cache_ke;
+	///damage at the concentration measurement times up to index k (trapezoidal rule only)
+	mutable std::vector<scalar_type > damage_Ct;
+	void gather_effect_per_time_step (
+			const double yt, 
+			const double
+		) const override {
+		double tau = dtau * static_cast<double>(tauit);		 //discrete absolute time
+		while ( tauit < M && tau < yt && tModel::TD_mod::is_still_gathering() ) {
+			GUTS_INSTRUMENT_COUNT(time_steps, 1);
+			if (tauit < damage_cache_size) {
+				// keep the state of the TK model for the following time steps
+				tModel::TK_mod::D = damage_cache[tauit];
+			} else {
+				damage_cache[tauit] = tModel::TK_mod::calculate_damage(k, tau);
+				damage_cache_size = tauit + 1;
+			}
+			D.at(tauit) = value_of(damage_cache[tauit]);
+			tModel::TD_mod::gather_effect(damage_cache[tauit]);
+			tau = dtau * static_cast<double>(++tauit);
+			if (this->trapezoid) {
+				// continue from the exact damage at each concentration measurement passed
+				while (k + 2 < tModel::TK_mod::Ct->size() && tau > tModel::TK_mod::Ct->at(k+1)) {
+					tModel::TK_mod::calculate_damage(k, tModel::TK_mod::Ct->at(k+1));
+					++k; // concentration index
+					tModel::TK_mod::update_to_next_concentration_measurement();
+					damage_Ct[k] = tModel::TK_mod::D_k;
+				}
+			} else if (tau > tModel::TK_mod::Ct->at(k+1)) {
+				++k; // concentration index
+				tModel::TK_mod::update_to_next_concentration_measurement();
+			}
+		}
+		if (this->trapezoid && tauit > 0) {
+			tModel::TD_mod::set_trapezoid_end(
+				damage_cache[tauit-1], calculate_damage_at(yt), yt - dtau * static_cast<double>(tauit-1)
+			);
+		}
+	}
+	/**
+	 * @returns damage at time t, from the damage at the start of its concentration interval
+	 * (t before the current time step, trapezoidal rule only); the state of the TK model is kept
+	 */
+	scalar_type calculate_damage_at(const double t) const {
+		std::size_t kt = k;
+		while (kt > 0 && t < tModel::TK_mod::Ct->at(kt)) --kt;
+		const scalar_type D_now = tModel::TK_mod::D;
+		const scalar_type D_k_now = tModel::TK_mod::D_k;
+		tModel::TK_mod::D_k = damage_Ct[kt];
+		const scalar_type Dt = tModel::TK_mod::calculate_damage(kt, t);
+		tModel::TK_mod::D = D_now;
+		tModel::TK_mod::D_k = D_k_now;
+		return Dt;
+	}
+};
+
+template<typename tModel, typename tt, typename tSurvival >
+struct guts_projector_fastIT: 
+  public guts_projector_base<tModel, tt, tSurvival > {
+public:
+	typedef tSurvival tProjection;
+	typedef guts_projector_base<tModel, tt, tSurvival > parent;
+	virtual ~guts_projector_fastIT() {}
+	inline void set_start_conditions() const override {
+		k = 0;
+		Dk = 0;
+		damage.resize(0);
+		damage_time.resize(0);
+		damage_time.push_back(0);
+		damage.push_back(0);
+		parent::set_start_conditions();
+	}
+	std::vector<double > get_damage() const override {
+		// ensure that the function is not called repeatedly. 
+		// Note: survival calculations automatically increase Dk.
+		if (Dk != 0) {
+			tModel::TK_mod::set_start_conditions();
+			extend_damage_values();
+		}
+		return damage;
+		}
+	std::vector<double > get_damage_time() const override {
+		// ensure that the function is not called repeatedly. 
+		// Note: survival calculations automatically increase Dk.
+		if (Dk != 0) {
+			tModel::TK_mod::set_start_conditions();
+			extend_damage_values();
+		}
+		return damage_time;
+	}
+	
+private:
+	mutable std::size_t k;
+	mutable std::size_t Dk;
+	mutable std::vector<double > damage_time;
+	mutable std::vector<double > damage;
+	void gather_effect_per_time_step (
+			const double yt, 
+			const double yt_previous
+		) const override {
+		double te;
+		std::size_t Dk_old = Dk;
+		while (this->Ct->at(k+1) < yt && this->is_still_gathering() ) {
+			//Note: the while loop excludes potential theoretical maxima before the second
+			//  concentration measurement.
+			//  This is correct with the underlying assumption that
+			//  at the beginning of the experiment, damage is 0 and thus 
+			//  the maximum of damage during this first concentration interval 
+			//  automatically is at yt that are measured during the first concentation
+			//  interval.
+			//  From the second concentration measurement on, all damage extremes 
+			//  are considered.
+			
+			// check damage at theoretical global maximum
+			if (this->is_maximum_damage(k)) {
+				//theoretically a maximum exists somewhere in time (at an extreme point)
+				//calculate the timing of the global maximum
+				te = this->calculate_time_of_extreme_damage(k);
+				if (te > yt_previous && te < yt) {
+					// the maximum is within the current survival measurement interval
+					if (te > this->Ct->at(k) && te < this->Ct->at(k+1)) {
+						// the maximum is within the current concentration measurement interval
+						damage_time.push_back(te);
+						damage.push_back(this->calculate_damage(k, te));
+						++Dk;
+					}
+				}
+			}
+		  // check damage at concentration measurement times (i.e. boundaries)
+		  	damage_time.push_back(this->Ct->at(k+1));
+		  	damage.push_back(this->calculate_damage(k, back(damage_time)));
+        ++Dk;
+        ++k;
+        this->update_to_next_concentration_measurement();
+		  }
+		damage_time.push_back(yt);
+		damage.push_back(this->calculate_damage(k, yt));
+		++Dk;
+		this->gather_effect( 
+				*(std::max_element(damage.begin() + Dk_old, damage.end())) 
+			);
+	}
+	
+	void extend_damage_values(std::size_t num_extra_evals_per_time_interval = 10) const {
+		double dtau;
+		double max_time = *(std::max_element(damage_time.begin(), damage_time.end()));
+		double cur_time;
+		k = 0;
+		Dk = 0;
+		while (this->Ct->at(k) < max_time) {
+				dtau = (this->Ct->at(k+1) - this->Ct->at(k)) / static_cast<double>(num_extra_evals_per_time_interval);
+				cur_time = this->Ct->at(k) + dtau;
+				do {
+					damage_time.push_back(cur_time);
+					damage.push_back(this->calculate_damage(k, cur_time));
+					cur_time += dtau;
+				} while (cur_time < this->Ct->at(k+1) && cur_time < max_time);
+				this->calculate_damage(k, this->Ct->at(k+1));
+				++k;
+				this->update_to_next_concentration_measurement();
+		}
+	}
+};
+
+template<typename tProjection, typename tmeasured_survivors >
+  double calculate_SPPE(const tProjection& p, const tmeasured_survivors& y) {
+    return (static_cast<double>(back(y)) / static_cast<double>(front(y)) - back(p)) * 100.0;
+  }
+
+template<typename tProjection, typename tmeasured_survivors >
+  double calculate_sum_of_squares(const tProjection& p, const tmeasured_survivors& y) {
+    double sum_of_squares = 0.0;
+    double diff;
+    
+    double y0 = static_cast<double>(front(y));
+    for (auto i=0; i < y.size(); ++i ) {
+      diff = static_cast<double>(y.at(i)) - y0 * p.at(i);
+      sum_of_squares += diff * diff;
+    }
+    
+    return sum_of_squares;
+  }
+
+#endif //GUTS_BASE_H_
@@ -0,0 +1,48 @@
+/**
+ * GUTS: Fast Calculation of the Likelihood of a Stochastic Survival Model.
+ * soeren.vogel@posteo.ch, carlo.albert@eawag.ch, alexander singer@rifcon.de, oliver.jakoby@rifcon.de, dirk.nickisch@rifcon.de
+ * License GPL-2
+ * 2017-10-09 
+ * updated: 2019-01-29
+ * updated: 2021-11-30 
+ * updated: 2026-10-19
+ */
+
+#ifndef TD_H
+#define TD_H
+
+#include "samplers.h"
+#include "TD_base.h"
+#include "TD_proper.h"
+#include "TD_SD.h"
+#include "TD_IT.h"
+
+
+typedef TD<imp_lognormal, 'P' > TD_proper_lognormal;
+typedef TD<imp_loglogistic, 'P' > TD_proper_loglogistic;
+typedef TD<imp_delta, 'P' > TD_proper_delta;
+typedef TD<quad_lognormal, 'P' > TD_proper_quad_lognormal;
+typedef TD<quad_loglogistic, 'P' > TD_proper_quad_loglogistic;
+template<typename tScalar >
+using TD_proper_lognormal_scalar = TD<basic_imp_lognormal<tScalar >, 'P' >;
+template<typename tScalar >
+using TD_proper_loglogistic_scalar = TD<basic_imp_loglogistic<tScalar >, 'P' >;
+template<typename tScalar >
+using TD_proper_delta_scalar = TD<basic_imp_delta<tScalar >, 'P' >;
+template<typename tScalar >
+using TD_proper_quad_lognormal_scalar = TD<basic_quad_lognormal<tScalar >, 'P' >;
+template<typename tScalar >
+using TD_proper_quad_loglogistic_scalar = TD<basic_quad_loglogistic<tScalar >, 'P' >;
+
+typedef TD<imp_lognormal, 'I' > TD_IT_imp_lognormal;
+typedef TD<imp_loglogistic, 'I' > TD_IT_imp_loglogistic;
+typedef TD<quad_lognormal, 'I' > TD_IT_quad_lognormal;
+typedef TD<quad_loglogistic, 'I' > TD_IT_quad_loglogistic;
+typedef TD<lognormal, 'I' > TD_IT_lognormal;
+typedef TD<loglogistic, 'I' > TD_IT_loglogistic;
+
+typedef TD<double, 'S' > TD_SD;
+template<typename tScalar >
+using TD_SD_scalar = TD<double, 'S', tScalar >;
+
+#endif //TD_H
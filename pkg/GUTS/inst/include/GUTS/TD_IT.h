@@ -7,6 +7,7 @@
  * updated: 2021-11-30 
  * updated: 2022-01-17
  * updated: 2022-02-01
+ * updated: 2026-10-19
  */
 
 #ifndef TD_IT_H
@@ -24,7 +25,7 @@
  * @brief accumulates damage above the threshold and executes respective mortality
  */
 template< typename sampler >
-class TD_IT_base : public TD_base, public background_mortality {
+class TD_IT_base : public TD_base<>, public background_mortality {
 public:
 	void initialize_from_parameters() override {}
   virtual ~TD_IT_base() {}
@@ -37,6 +38,7 @@ public:
         * \param[in] D damage
         */
         inline void gather_effect(const double D) const override {
+          GUTS_INSTRUMENT_COUNT(gather_effect, 1);
           zit = std::lower_bound(this->zit, samp.end(), D);
           // zit points to lowest z >= D
         }
@@ -47,7 +49,7 @@ public:
     mutable typename sampler::sample_type::const_iterator zit;
 };
 
-double sumExp(const double& a, const double& b) {return a + std::exp(b);}
+inline double sumExp(const double& a, const double& b) {return a + std::exp(b);}
 
 template< typename sampler >
 class TD<sampler, 'I' > : public TD_IT_base<sampler > {
@@ -63,14 +65,20 @@ public:
     initialize(TDdata.N);
   }
   inline void set_start_conditions() const override {
-  	this->samp.calc_sample();
-  	this->zit = this->samp.z.begin();
-	  std::vector<double >::reverse_iterator it = Sj.rbegin();
-	  this->zw.back() = exp(this->zw.back());
-	  std::partial_sum(this->zw.rbegin(), this->zw.rend(), it, sumExp);
+  	{
+  	  GUTS_INSTRUMENT_SCOPE(sample);
+  	  this->samp.calc_sample();
+  	}
+  	this->zit = this->samp.begin();
+	  // Sj[j]: sum of the weights of thresholds z[k], k >= j
+	  double S = 0.0;
+	  for (std::size_t j = Sj.size(); j > 0; --j) {
+	    S += std::exp(this->samp.weight_at(j - 1));
+	    Sj[j - 1] = S;
+	  }
   }
   inline double calculate_current_survival(const double yt) const override {
-    return this->zit == this->z.end() ? 0 : Sj.at(this->zit - this->z.begin())  / this->samp.sample_size() * exp( -this->hb * yt );
+    return this->zit == this->samp.end() ? 0 : Sj.at(this->zit - this->samp.begin())  / this->samp.sample_size() * exp( -this->hb * yt );
   }
 private:
   mutable std::vector<double > Sj;
@@ -78,7 +86,7 @@ private:
 
 
 struct TD_IT_CDF :
-		virtual public TD_base,
+		virtual public TD_base<>,
 		virtual public background_mortality {
 	virtual ~TD_IT_CDF() {}
 	  template<typename tTDdata >
@@ -101,6 +109,7 @@ public TD_IT_CDF
 public:
   virtual ~TD() {}
   inline void gather_effect(const double D) const override {
+	GUTS_INSTRUMENT_COUNT(gather_effect, 1);
 	M = std::max(M, samp.CDF(D));
   }
 	loglogistic samp;
@@ -113,6 +122,7 @@ public TD_IT_CDF
 public:
   virtual ~TD() {}
   inline void gather_effect(const double D) const override {
+	GUTS_INSTRUMENT_COUNT(gather_effect, 1);
 	M = std::max(M, samp.CDF(D));
   }
 	lognormal samp;
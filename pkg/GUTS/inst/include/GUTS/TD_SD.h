@@ -0,0 +1,92 @@
+/**
+ * GUTS: Fast Calculation of the Likelihood of a Stochastic Survival Model.
+ * soeren.vogel@posteo.ch, carlo.albert@eawag.ch, alexander singer@rifcon.de, oliver.jakoby@rifcon.de, dirk.nickisch@rifcon.de
+ * License GPL-2
+ * 2017-10-09 
+ * updated: 2019-01-29
+ * updated: 2021-11-30 
+ * updated: 2022-01-17
+ * updated: 2026-10-19
+ */
+
+#ifndef TD_SD_H
+#define TD_SD_H
+
+#include "TD_base.h"
+#include "external_data.h"
+
+template<typename tScalar >
+class TD<double, 'S', tScalar > : public TD_base<tScalar > {
+public:
+  TD() : TD_base<tScalar >(), E(), E_end(), dtau(), kk(), kkXdtau(), hb(), z() {}
+  virtual ~TD() {}
+  template<typename tTDdata >
+  inline void initialize(const tTDdata& TDdata) {
+	  dtau = TDdata.calculate_dtau();
+  }
+  void initialize_from_parameters() override {}
+  inline void set_start_conditions() const override {
+    E = 0.0;
+    E_end = 0.0;
+  }
+  bool is_still_gathering() const override {return true;}
+  /**
+  * @returns true if there are still survivors
+  */
+  inline void set_killing_rate(const tScalar new_kk) {
+    kkXdtau = new_kk * dtau;
+    kk = new_kk;
+  }
+  inline void set_background_mortality(const tScalar new_hb) {hb = new_hb;}
+  inline void set_threshold(const tScalar new_z) {z = new_z;}
+  inline tScalar get_killing_rate() const {return kk;}
+  inline tScalar get_background_mortality() const {return hb;}
+  inline tScalar get_threshold() const {return z;}
+  inline void update_to_next_survival_measurement() const override {}
+  /**
+   *\brief gather an effect from known damage
+   * \param[in] D damage
+   */
+  inline void gather_effect(const tScalar D) const override {
+    GUTS_INSTRUMENT_COUNT(gather_effect, 1);
+    if ( D > z ) E += z - D;
+  }
+  /**
+   * \brief correct the accumulated effect to the trapezoidal rule (see TD_base)
+   */
+  inline void set_trapezoid_end(const tScalar D_last, const tScalar D_end, const double w) const override {
+    const tScalar f0 = z < 0.0 ? tScalar(-z) : tScalar(0.0);
+    const tScalar f_last = D_last > z ? tScalar(D_last - z) : tScalar(0.0);
+    const tScalar f_end = D_end > z ? tScalar(D_end - z) : tScalar(0.0);
+    E_end = 0.5 * (f0 + f_last) - 0.5 * (w / dtau) * (f_last + f_end);
+  }
+  /**
+   * \returns  calculate survival at time yt
+   * \param[in] yt survival measurement time
+   */
+  inline tScalar calculate_current_survival(const double yt) const override {
+    using std::exp;
+    return exp(kkXdtau * (E + E_end) - hb * yt);
+  }
+  inline tScalar calculate_current_log_survival(const double yt) const override {
+    return kkXdtau * (E + E_end) - hb * yt;
+  }
+  
+protected:
+  ///internally accumulated effect
+  mutable tScalar E;
+  ///correction of E to the trapezoidal rule (see set_trapezoid_end)
+  mutable tScalar E_end;
+  ///duration of discretization time step
+  double dtau;
+  ///killing rate
+  tScalar kk;
+  ///killing rate times discrete time step
+  tScalar kkXdtau;
+  ///background mortality
+  tScalar hb;
+  ///threshold value
+  tScalar z;
+};
+
+#endif //TD_SD_H
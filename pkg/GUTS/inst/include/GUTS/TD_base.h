@@ -0,0 +1,108 @@
+/**
+ * GUTS: Fast Calculation of the Likelihood of a Stochastic Survival Model.
+ * soeren.vogel@posteo.ch, carlo.albert@eawag.ch, alexander singer@rifcon.de, oliver.jakoby@rifcon.de, dirk.nickisch@rifcon.de
+ * License GPL-2
+ * 2017-10-09 
+ * updated: 2019-01-29
+ * updated: 2021-11-30
+ * updated: 2022-01-17 
+ * updated: 2026-10-19
+ */
+
+#ifndef TD_BASE_H
+#define TD_BASE_H
+
+#include <cmath>
+#include <limits>
+
+#include "guts_instrument.h"
+#include "guts_status.h"
+
+/**
+ * @class abstract TD interface
+ * 
+ * @brief accumulates damage above the threshold and executes respective mortality
+ * @tparam tScalar numeric type of damage and survival (double, or dual numbers for derivatives w.r.t. parameters)
+ */
+template<typename tScalar = double >
+class TD_base {
+public:
+  typedef tScalar scalar_type;
+	virtual ~TD_base() {}
+  /**
+   * @brief gather an effect from known damage
+   * @param[in] D damage
+   */
+  virtual void gather_effect(const tScalar D) const = 0;
+  /**
+   * @brief calculate survival rate at time yt
+   * @param[in] yt time
+   * @returns the survival probability
+   */
+  virtual tScalar calculate_current_survival(const double yt) const = 0;
+  /**
+   * @brief calculate the logarithm of the survival rate at time yt
+   * @details Specializations override this to avoid underflow of the survival rate.
+   * @param[in] yt time
+   * @returns the logarithm of the survival probability
+   */
+  virtual tScalar calculate_current_log_survival(const double yt) const {
+    using std::log;
+    return log(calculate_current_survival(yt));
+  }
+  /**
+   * @brief simulate the number of survivors from the number of survivors in the previous time step
+   * @param[in] y_previous: number of survivors in previous time step
+   * @results simulated number of survivors
+   */
+  //virtual std::size_t simulate_current_number_of_survivors(const std::size_t y_previous) = 0;
+  /**
+   * @returns true if damage has not been gathered for all individuals/threshold values 
+   */
+  virtual bool is_still_gathering() const = 0;
+  /**
+   * @brief end of the damage gathered for the next survival calculation (trapezoidal rule)
+   * @details gather_effect sums damage on the time grid (rectangle rule, error O(dtau)).
+   * Time-discrete TDs that override this correct the sum to the trapezoidal rule up to yt:
+   * half weight of the damage at time 0 (no damage) and at the last time step before yt,
+   * plus the trapezoid from the last time step to yt. The rectangle rule applies until the
+   * next call, and after set_start_conditions().
+   * @param[in] D_last damage at the last time step before yt
+   * @param[in] D_end damage at yt
+   * @param[in] w time from the last time step to yt
+   */
+  virtual void set_trapezoid_end(const tScalar, const tScalar, const double) const {}
+  virtual void update_to_next_survival_measurement() const = 0;
+  virtual void set_start_conditions() const = 0;
+  virtual void initialize_from_parameters() = 0;
+  /**
+   * @returns guts_status::ok if survival can be calculated from the current parameters
+   */
+  virtual guts_status check_parameters() const {return guts_status::ok;}
+};
+
+/**
+ * \brief abstract template needs specialization
+ * \tparam sampler sampler to generate the threshold distribution
+ * \tparam TD_type one of three char types
+ *    - P proper
+ *    - I IT
+ *    - S SD
+ * \tparam tScalar numeric type of damage and survival (SD only; proper models take it from the sampler)
+ *  \details this template must be specialized
+ */
+template< typename sampler, char TD_type, typename tScalar = double >
+class TD {TD();};
+
+struct background_mortality {
+	background_mortality() :
+		hb(std::numeric_limits<double>::quiet_NaN())
+	{}
+	virtual ~background_mortality() {}
+	inline void set_background_mortality(const double new_hb) {hb = new_hb;}
+	inline double get_background_mortality() const {return hb;}
+protected:
+    ///background mortality
+    double hb;
+};
+#endif //TD_BASE_H
@@ -0,0 +1,323 @@
+/**
+ * GUTS: Fast Calculation of the Likelihood of a Stochastic Survival Model.
+ * soeren.vogel@posteo.ch, carlo.albert@eawag.ch, alexander singer@rifcon.de, oliver.jakoby@rifcon.de, dirk.nickisch@rifcon.de
+ * License GPL-2
+ * 2017-10-09 
+ * updated: 2019-01-29
+ * updated: 2021-11-30 
+ * updated: 2022-01-17
+ * updated: 2026-10-19
+ */
+
+
+#ifndef TD_PROPER_H
+#define TD_PROPER_H
+
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include <iostream>
+#include <algorithm>
+
+#include "TD_base.h"
+#include "samplers.h"
+#include "helpers.h"
+
+/**
+ * @brief storage and accumulation of gathered damage of proper models
+ *
+ * @details Defined by the type of threshold variates: double, or dual numbers for derivatives.
+ * With single precision, gathered damage is stored as float (half the memory traffic of large N).
+ * Consecutive time steps in the same bin are summed in double and added to the bin once (see
+ * TD_proper_base::add_to_bin), and sums over bins are accumulated in double with compensation
+ * (see compensated_sum).
+ */
+template<typename tReal >
+struct proper_precision {
+	typedef tReal bin_type;
+	typedef tReal sum_type;
+};
+template<>
+struct proper_precision<float > {
+	typedef float bin_type;
+	typedef compensated_sum sum_type;
+};
+
+/**
+ * @class abstract TD interface
+ * 
+ * @brief accumulates damage above the threshold and executes respective mortality
+ * @details Damage, parameters and survival are of the scalar type of the sampler (see
+ * basic_importance_sampler).
+ */
+template< typename sampler, typename tPrecision = proper_precision<typename sampler::sample_type::value_type > >
+class TD_proper_base : public TD_base<typename sampler::scalar_type > {
+public:
+	typedef typename sampler::scalar_type scalar_type;
+	typedef typename tPrecision::bin_type bin_type;
+	typedef typename tPrecision::sum_type sum_type;
+	TD_proper_base() : TD_base<scalar_type >(), samp(), ee(), ff(), zpos(0),
+	kk(std::numeric_limits<double>::quiet_NaN()),
+	dtau(std::numeric_limits<double>::quiet_NaN()),
+	kkXdtau(std::numeric_limits<double>::quiet_NaN()),
+	hb(std::numeric_limits<double>::quiet_NaN()),
+	trapezoid_end(false), D_last(0.0), D_end(0.0), w_end(0.0),
+	pending_bin(no_bin), pending_D(0.0)
+{}
+	virtual ~TD_proper_base() {}
+	bool is_still_gathering() const override {return true;}
+	inline void set_killing_rate(const scalar_type new_kk) {
+		kkXdtau = new_kk * dtau;
+		kk = new_kk;
+	}
+	inline void set_background_mortality(const scalar_type new_hb) {hb = new_hb;}
+	inline scalar_type get_killing_rate() const {return kk;}
+	inline scalar_type get_background_mortality() const {return hb;}
+	void update_to_next_survival_measurement() const override {}
+	/**
+	 * @brief gather an effect from known damage
+	 * @param[in] D damage
+	 */
+	inline void gather_effect(const scalar_type D) const override {
+		GUTS_INSTRUMENT_COUNT(gather_effect, 1);
+		if ( D > samp.variate_back() ) {
+			// damage higher than the largest value in threshold distribution
+			add_to_bin(ee.size() - 1, D);
+			ff.back() ++;
+			return;
+		}
+		if ( D > samp.variate_at(0) ) {
+			// damage within threshold distribution
+			// Search quantile in threshold distribution that covers the damage.
+			while ( zpos > 0 && D < samp.variate_at(zpos)) {
+				--zpos;
+				GUTS_INSTRUMENT_COUNT(bin_walk, 1);
+			}
+			while ( zpos < (samp.sample_size() - 1) && D > samp.variate_at(zpos) ) {
+				++zpos;
+				GUTS_INSTRUMENT_COUNT(bin_walk, 1);
+			}
+			add_to_bin(zpos - 1, D);
+			ff.at(zpos-1)++;
+		}
+	}
+
+	inline void set_start_conditions() const override {
+		std::fill(ee.begin(), ee.end(), 0.0);
+		std::fill(ff.begin(), ff.end(), 0);
+		zpos = samp.sample_size()/2;
+		trapezoid_end = false;
+		pending_bin = no_bin;
+		pending_D = 0.0;
+	}
+	/**
+	 * @brief correct the gathered damage of each threshold to the trapezoidal rule (see TD_base)
+	 */
+	inline void set_trapezoid_end(const scalar_type new_D_last, const scalar_type new_D_end, const double w) const override {
+		trapezoid_end = true;
+		D_last = new_D_last;
+		D_end = new_D_end;
+		w_end = w / dtau;
+	}
+protected:
+	void initialize_threshold_distribution(const std::size_t sample_size) {
+		GUTS_INSTRUMENT_COUNT(allocations, 2);
+		ee.assign(sample_size, 0.0);
+		ff.assign(sample_size, 0);
+	}
+	void initialize_time_discretization(const double new_dtau) {
+		dtau = new_dtau;
+	}
+	/**
+	 * @brief add damage to bin i
+	 * @details Bins of type double add directly. Bins of type float would round at each time
+	 * step, such that the error grows with the number of steps in a bin (e.g. damage above all
+	 * thresholds). Consecutive damage of a bin is therefore summed in double and rounded once
+	 * when another bin is hit, or by flush_bins() before survival is calculated.
+	 */
+	inline void add_to_bin(const std::size_t i, const scalar_type D) const {
+		if (!std::is_same<bin_type, float >::value) {
+			ee.at(i) += D;
+			return;
+		}
+		if (i != pending_bin) {
+			flush_bins();
+			pending_bin = i;
+		}
+		pending_D += D;
+	}
+	inline void flush_bins() const {
+		if (pending_bin == no_bin) return;
+		ee.at(pending_bin) = static_cast<bin_type >(ee.at(pending_bin) + pending_D);
+		pending_bin = no_bin;
+		pending_D = 0.0;
+	}
+	/**
+	 * @returns the correction of z F - E (the negative sum of damage above threshold z)
+	 * to the trapezoidal rule; 0 with the rectangle rule
+	 */
+	inline scalar_type trapezoid_correction(const scalar_type& z) const {
+		if (!trapezoid_end) return 0.0;
+		const scalar_type f0 = z < 0.0 ? scalar_type(-z) : scalar_type(0.0);
+		const scalar_type f_last = D_last > z ? scalar_type(D_last - z) : scalar_type(0.0);
+		const scalar_type f_end = D_end > z ? scalar_type(D_end - z) : scalar_type(0.0);
+		return 0.5 * (f0 + f_last) - 0.5 * w_end * (f_last + f_end);
+	}
+public:
+	///the sampler
+	mutable sampler samp;
+protected:
+	///brief gathered damage
+	mutable std::vector<bin_type > ee;
+	///brief frequency distribution of damage == threshold
+	mutable std::vector<unsigned > ff;
+	mutable std::size_t zpos;
+	///killing rate
+	scalar_type kk;
+	///length discrete time step
+	double dtau;
+	///killing rate times discrete time step
+	scalar_type kkXdtau;
+	///background mortality
+	scalar_type hb;
+	///end of the gathered damage for the trapezoidal rule (see set_trapezoid_end)
+	mutable bool trapezoid_end;
+	mutable scalar_type D_last;
+	mutable scalar_type D_end;
+	///time from the last time step to the end, in units of dtau
+	mutable double w_end;
+	///bin and damage not yet added to ee (see add_to_bin)
+	static constexpr std::size_t no_bin = std::numeric_limits<std::size_t >::max();
+	mutable std::size_t pending_bin;
+	mutable scalar_type pending_D;
+};
+
+template<typename sampler >
+struct TD_proper_impsampling : public TD_proper_base<sampler > {
+	typedef typename TD_proper_base<sampler >::scalar_type scalar_type;
+	typedef typename TD_proper_base<sampler >::sum_type sum_type;
+	TD_proper_impsampling() : TD_proper_base<sampler >() {}
+	void set_start_conditions() const override {
+		TD_proper_base<sampler >::set_start_conditions();
+		GUTS_INSTRUMENT_SCOPE(sample);
+		this -> samp.calc_sample();
+	}
+	scalar_type calculate_current_survival(const double yt) const override {
+		using std::exp;
+		this->flush_bins();
+		sum_type E = 0.0;
+		unsigned F = 0;
+		scalar_type S = 0;
+		std::size_t N = this->samp.sample_size();
+		for (std::size_t u = N; u > 0; --u) {
+			F += this->ff.at(u-1);
+			E += this->ee.at(u-1);
+			const scalar_type c = this->trapezoid_correction(this->samp.variate_at(u-1));
+			S += F == 0 && c == 0.0 ? scalar_type(exp(this->samp.weight_at(u-1) )) : exp((this->kkXdtau * (this->samp.variate_at(u-1) * F - E + c)) + this->samp.weight_at(u-1) );
+		}
+		return S * exp( -this->hb * yt ) / static_cast<double>(this->samp.sample_size());
+	}
+	scalar_type calculate_current_log_survival(const double yt) const override {
+		using std::log;
+		this->flush_bins();
+		sum_type E = 0.0;
+		unsigned F = 0;
+		scalar_type a_max = -std::numeric_limits<double>::infinity();
+		scalar_type S = 0;
+		std::size_t N = this->samp.sample_size();
+		for (std::size_t u = N; u > 0; --u) {
+			F += this->ff.at(u-1);
+			E += this->ee.at(u-1);
+			const scalar_type c = this->trapezoid_correction(this->samp.variate_at(u-1));
+			add_to_log_sum_exp(
+				F == 0 && c == 0.0 ? scalar_type(this->samp.weight_at(u-1)) : (this->kkXdtau * (this->samp.variate_at(u-1) * F - E + c)) + this->samp.weight_at(u-1),
+				a_max, S
+			);
+		}
+		return a_max + log(S) - this->hb * yt - std::log(static_cast<double>(N));
+	}
+	guts_status check_parameters() const override {
+		return this->samp.check_parameters();
+	}
+	virtual ~TD_proper_impsampling() {}
+protected:
+	void initialize_from_parameters() override {}
+	inline void initialize(const double new_dtau, const std::size_t sample_size) {
+		this -> samp.initialize(sample_size);
+		TD_proper_impsampling<sampler >::initialize_threshold_distribution(sample_size);
+		TD_proper_impsampling<sampler >::initialize_time_discretization(new_dtau);
+	}
+};
+
+template< typename sampler >
+class TD<sampler, 'P' > : public TD_proper_impsampling<sampler > {
+public:
+	TD() : TD_proper_impsampling<sampler >() {}
+	template<typename tTDdata >
+	inline void initialize(const tTDdata& TDdata) {
+		this->samp.initialize(TDdata.N);
+		this->initialize_threshold_distribution(TDdata.N);
+		this->initialize_time_discretization(TDdata.calculate_dtau());
+	}
+	virtual ~TD() {}
+};
+
+template<typename tScalar >
+struct TD<basic_imp_delta<tScalar >, 'P' > : public TD_proper_impsampling<basic_imp_delta<tScalar > > {
+	TD() : TD_proper_impsampling<basic_imp_delta<tScalar > >() {}
+	template<typename tTDdata >
+	inline void initialize(const tTDdata& TDdata) {
+		this->samp.initialize();
+		this->initialize_threshold_distribution(1);
+		this->initialize_time_discretization(TDdata.calculate_dtau());
+	}
+	inline void set_threshold(const tScalar new_z) {this->samp.set_threshold(new_z);}
+	inline tScalar get_threshold() const {return this->samp.get_threshold();}
+	virtual ~TD() {}
+};
+
+template<typename tz >
+class TD<random_sample<tz >, 'P' >: public TD_proper_base<random_sample<tz > > {
+public:
+	typedef typename TD_proper_base<random_sample<tz > >::sum_type sum_type;
+	TD() : TD_proper_base<random_sample<tz > >() {  }
+	template<typename tTDdata >
+	inline void initialize(const tTDdata& TDdata) {
+		TD_proper_base<random_sample<tz > >::initialize_time_discretization(TDdata.calculate_dtau());
+	}
+	void initialize_from_parameters() override {
+		TD_proper_base<random_sample<tz > >::initialize_threshold_distribution(
+				this->samp.sample_size()
+		);
+	}
+	virtual ~TD() {}
+	inline double calculate_current_survival(const double yt) const override {
+		this->flush_bins();
+		sum_type E = 0.0;
+		unsigned F = 0;
+		double S = 1;
+		std::size_t N = this->samp.sample_size();
+		for (std::size_t u = N; u > 0; --u) {
+			E += this->ee.at(u - 1);
+			F += this->ff.at(u - 1);
+			S += exp(   (this->kkXdtau * (this->samp.variate_at(u - 1) * F - E + this->trapezoid_correction(this->samp.variate_at(u - 1)))) );
+		}
+		return S * exp( -this->hb * yt ) / static_cast<double>(N);
+	}
+	inline double calculate_current_log_survival(const double yt) const override {
+		this->flush_bins();
+		sum_type E = 0.0;
+		unsigned F = 0;
+		double a_max = 0.0;
+		double S = 1;
+		std::size_t N = this->samp.sample_size();
+		for (std::size_t u = N; u > 0; --u) {
+			E += this->ee.at(u - 1);
+			F += this->ff.at(u - 1);
+			add_to_log_sum_exp(this->kkXdtau * (this->samp.variate_at(u - 1) * F - E + this->trapezoid_correction(this->samp.variate_at(u - 1))), a_max, S);
+		}
+		return a_max + std::log(S) - this->hb * yt - std::log(static_cast<double>(N));
+	}
+};
+#endif //TD_PROPER_H
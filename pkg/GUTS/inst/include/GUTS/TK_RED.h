@@ -6,6 +6,7 @@
  * updated: 2019-01-29
  * updated: 2021-11-30 
  * updated: 2022-01-17
+ * updated: 2026-10-19
  */
 
 #ifndef TK_RED_H
@@ -18,17 +19,19 @@
 #include <iostream>
 
 #include "TK_single_concentration.h"
+#include "guts_instrument.h"
 
 /**
  * @class TK-RED: assuming the concentration is linearly interpolated between measurements.
+ * @tparam tScalar numeric type of the rate constant and damage
  */
-template<typename tCt, typename tC >
-class TK_RED : public TK_single_concentration<tCt, tC > {
-	typedef TK_single_concentration<tCt, tC > parent;
+template<typename tCt, typename tC, typename tScalar = double >
+class TK_RED : public TK_single_concentration<tCt, tC, tScalar > {
+	typedef TK_single_concentration<tCt, tC, tScalar > parent;
 public:
 	TK_RED (): parent(), ke(std::numeric_limits<double>::quiet_NaN()) {}
 	virtual ~TK_RED () {}
-	inline virtual void set_dominant_rate_constant(const double new_ke) {
+	inline virtual void set_dominant_rate_constant(const tScalar new_ke) {
 		ke = new_ke;
 		ke_times_SVR = ke * SVR;
 	}
@@ -44,7 +47,7 @@ public:
 	inline void initialize(const tTDdata& TDdata) {
 		initialize(TDdata.Ct, TDdata.C, TDdata.SVR);
 	}
-	inline double get_dominant_rate_constant() const {return ke;}
+	inline tScalar get_dominant_rate_constant() const {return ke;}
 	/**
 	 * @brief Solve differential damage equation at time $t$
 	 *
@@ -53,10 +56,11 @@ public:
 	 * @param[in] t time at which to calculate the damage
 	 * @param[in] k index of concentration measurement interval. The index defines the boundary (starting) conditions and must point to the concentration measurement interval in which t lies (i.e. Ct[k] <= t < Ct[k+1])
 	 */
-	inline double calculate_damage(const std::size_t k, const double t) const override {
-		double tmp = exp( -ke_times_SVR * (t - this->Ct->at(k)) );
-		double summand3 =
-			ke_times_SVR > 0.0  ? (t - this->Ct->at(k) - (1.0-tmp)/ke_times_SVR)  *  this->diffCCt[k] : 0.0;
+	inline tScalar calculate_damage(const std::size_t k, const double t) const override {
+		GUTS_INSTRUMENT_COUNT(calculate_damage, 1);
+		tScalar tmp = exp( -ke_times_SVR * (t - this->Ct->at(k)) );
+		tScalar summand3 =
+			ke_times_SVR > 0.0  ? (t - this->Ct->at(k) - (1.0-tmp)/ke_times_SVR)  *  this->diffCCt[k] : tScalar(0.0);
 		this -> D = tmp * (this->D_k - this->C->at(k)) + this->C->at(k) + summand3;
 		return this -> D;
 	}
@@ -66,7 +70,7 @@ public:
 	 * @details solution of the first derivative of damage is 0 ($\frac{dD}{dt} = 0$).
 	 * @param[in] k index of concentration measurement interval (points to the beginning of the interval).
 	 */
-	inline double calculate_time_of_extreme_damage(const std::size_t k) const {
+	inline tScalar calculate_time_of_extreme_damage(const std::size_t k) const {
 		return log((this->D_k - this->C->at(k))*ke_times_SVR/this->diffCCt.at(k) + 1) / ke_times_SVR + this->Ct->at(k);
 	}
 	/**
@@ -76,7 +80,7 @@ public:
 	 * @param[in] te time at which the damage assumes an extreme value (as calculated in calculate_time_of_extreme_damage(const std::size_t))
 	 * @param[in] k index of concentration measurement interval (points to the beginning of the interval)
 	 */
-	inline double calculate_extreme_damage(const double te, const std::size_t k) const {
+	inline tScalar calculate_extreme_damage(const tScalar te, const std::size_t k) const {
 		return this->diffCCt.at(k) * (te - this->Ct->at(k)) + this->C->at(k);
 	}
 	/**
@@ -89,8 +93,8 @@ public:
 		return this->D_k < this->Ct->at(k) - this->diffCCt.at(k) / ke_times_SVR;
 	}
 protected:
-	double ke;
+	tScalar ke;
 	double SVR;
-	double ke_times_SVR;
+	tScalar ke_times_SVR;
 };
 #endif //TK_RED_H
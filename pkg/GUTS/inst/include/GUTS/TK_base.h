@@ -6,6 +6,7 @@
  * updated: 2019-01-29
  * updated: 2021-11-30 
  * updated: 2022-01-17
+ * updated: 2026-10-19
  */
 
 #ifndef TK_BASE_H
@@ -23,11 +24,14 @@
  * @details The method double calculate_current_D() solves the TK equation at the next discretization step and returns the damage.
  * The function is called within a while-loop that iterates until bool is_timestep_in_range(const double) fails.
  * The discretization iterator is automatically updated.
+ * @tparam tScalar numeric type of the damage (double, or dual numbers for derivatives w.r.t. parameters)
  */
+template<typename tScalar = double >
 struct TK {
+  typedef tScalar scalar_type;
   TK() {}
   virtual ~TK() {}
-  virtual double calculate_damage(
+  virtual tScalar calculate_damage(
       const std::size_t k, const double tau) const = 0;
   virtual void set_start_conditions() const = 0;
   virtual void initialize_from_parameters() = 0; 
@@ -6,6 +6,7 @@
  * updated: 2019-01-29
  * updated: 2021-11-30
  * updated: 2022-01-17 
+ * updated: 2026-10-19
  */
 
 #ifndef TK_single_concentration_H
@@ -26,8 +27,8 @@
  * The function is called within a while-loop that iterates until bool is_timestep_in_range(const double) fails.
  * The discretized iterator is automatically updated.
  */
-template<typename tCt, typename tC >
-class TK_single_concentration : public TK  {
+template<typename tCt, typename tC, typename tScalar = double >
+class TK_single_concentration : public TK<tScalar >  {
 public:
   template<typename tTDdata >
     inline void initialize(const tTDdata& TDdata) {
@@ -57,9 +58,9 @@ protected:
   ///brief differential of concentrations C at measurement times Ct
   std::vector<double > diffCCt;
   ///brief current damage
-  mutable double D;
+  mutable tScalar D;
   ///brief damage at last concentration measurement time step
-  mutable double D_k;
+  mutable tScalar D_k;
 private:
   /**
    * @brief Differentiate the external concentration C
@@ -71,9 +72,9 @@ private:
   virtual void differentiateC();
 };
 
-template<typename tCt, typename tC > 
-void TK_single_concentration<tCt, tC >::differentiateC() {
-  for ( auto i = 1; i < Ct->size(); ++i ) {
+template<typename tCt, typename tC, typename tScalar > 
+void TK_single_concentration<tCt, tC, tScalar >::differentiateC() {
+  for ( std::size_t i = 1; i < Ct->size(); ++i ) {
     diffCCt.at(i-1) = (C->at(i) - C->at(i-1)) /
     		(Ct->at(i) - Ct->at(i-1));
   }
@@ -0,0 +1,126 @@
+/**
+ * GUTS: Fast Calculation of the Likelihood of a Stochastic Survival Model.
+ * soeren.vogel@posteo.ch, carlo.albert@eawag.ch, alexander singer@rifcon.de, oliver.jakoby@rifcon.de, dirk.nickisch@rifcon.de
+ * License GPL-2
+ * 2026-10-19
+ */
+
+#ifndef GUTS_DUAL_H
+#define GUTS_DUAL_H
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+/**
+ * \brief Dual number for forward-mode automatic differentiation
+ * \details Holds a value and its partial derivatives with respect to n independent
+ * variables. Arithmetic and the elementary functions used by GUTS models propagate
+ * the derivatives by the chain rule, such that a projection with dual parameters
+ * yields the loglikelihood and its exact gradient in one pass.
+ * Comparisons only consider values; hence, derivatives are those of the branch taken.
+ * \tparam n number of independent variables
+ */
+template<std::size_t n >
+struct dual {
+  double v;
+  std::array<double, n > d;
+  dual() : v(0.0) {d.fill(0.0);}
+  dual(const double new_v) : v(new_v) {d.fill(0.0);}
+  /**
+   * \brief independent variable i with value new_v
+   */
+  dual(const double new_v, const std::size_t i) : v(new_v) {
+    d.fill(0.0);
+    d[i] = 1.0;
+  }
+  inline dual& operator+=(const dual& b) {
+    v += b.v;
+    for (std::size_t i = 0; i < n; ++i) d[i] += b.d[i];
+    return *this;
+  }
+  inline dual& operator-=(const dual& b) {
+    v -= b.v;
+    for (std::size_t i = 0; i < n; ++i) d[i] -= b.d[i];
+    return *this;
+  }
+  inline dual& operator*=(const dual& b) {
+    for (std::size_t i = 0; i < n; ++i) d[i] = d[i] * b.v + v * b.d[i];
+    v *= b.v;
+    return *this;
+  }
+  inline dual& operator/=(const dual& b) {
+    const double q = v / b.v;
+    for (std::size_t i = 0; i < n; ++i) d[i] = (d[i] - q * b.d[i]) / b.v;
+    v = q;
+    return *this;
+  }
+};
+
+template<std::size_t n > inline dual<n > operator+(dual<n > a, const dual<n >& b) {return a += b;}
+template<std::size_t n > inline dual<n > operator+(dual<n > a, const double b) {a.v += b; return a;}
+template<std::size_t n > inline dual<n > operator+(const double a, dual<n > b) {b.v += a; return b;}
+template<std::size_t n > inline dual<n > operator-(dual<n > a, const dual<n >& b) {return a -= b;}
+template<std::size_t n > inline dual<n > operator-(dual<n > a, const double b) {a.v -= b; return a;}
+template<std::size_t n > inline dual<n > operator-(const double a, const dual<n >& b) {return dual<n >(a) -= b;}
+template<std::size_t n > inline dual<n > operator-(dual<n > a) {
+  a.v = -a.v;
+  for (auto& x : a.d) x = -x;
+  return a;
+}
+template<std::size_t n > inline dual<n > operator*(dual<n > a, const dual<n >& b) {return a *= b;}
+template<std::size_t n > inline dual<n > operator*(dual<n > a, const double b) {
+  a.v *= b;
+  for (auto& x : a.d) x *= b;
+  return a;
+}
+template<std::size_t n > inline dual<n > operator*(const double a, const dual<n >& b) {return b * a;}
+template<std::size_t n > inline dual<n > operator/(dual<n > a, const dual<n >& b) {return a /= b;}
+template<std::size_t n > inline dual<n > operator/(const dual<n >& a, const double b) {return a * (1.0 / b);}
+template<std::size_t n > inline dual<n > operator/(const double a, const dual<n >& b) {return dual<n >(a) /= b;}
+
+template<std::size_t n > inline bool operator<(const dual<n >& a, const dual<n >& b) {return a.v < b.v;}
+template<std::size_t n > inline bool operator<(const dual<n >& a, const double b) {return a.v < b;}
+template<std::size_t n > inline bool operator<(const double a, const dual<n >& b) {return a < b.v;}
+template<std::size_t n > inline bool operator>(const dual<n >& a, const dual<n >& b) {return a.v > b.v;}
+template<std::size_t n > inline bool operator>(const dual<n >& a, const double b) {return a.v > b;}
+template<std::size_t n > inline bool operator>(const double a, const dual<n >& b) {return a > b.v;}
+template<std::size_t n > inline bool operator<=(const dual<n >& a, const dual<n >& b) {return a.v <= b.v;}
+template<std::size_t n > inline bool operator<=(const dual<n >& a, const double b) {return a.v <= b;}
+template<std::size_t n > inline bool operator<=(const double a, const dual<n >& b) {return a <= b.v;}
+template<std::size_t n > inline bool operator>=(const dual<n >& a, const dual<n >& b) {return a.v >= b.v;}
+template<std::size_t n > inline bool operator>=(const dual<n >& a, const double b) {return a.v >= b;}
+template<std::size_t n > inline bool operator>=(const double a, const dual<n >& b) {return a >= b.v;}
+template<std::size_t n > inline bool operator==(const dual<n >& a, const dual<n >& b) {return a.v == b.v;}
+template<std::size_t n > inline bool operator==(const dual<n >& a, const double b) {return a.v == b;}
+template<std::size_t n > inline bool operator==(const double a, const dual<n >& b) {return a == b.v;}
+
+/**
+ * \brief apply the derivative f1 = f'(a) of a function with value f0 = f(a)
+ */
+template<std::size_t n > inline dual<n > chain(const dual<n >& a, const double f0, const double f1) {
+  dual<n > r(f0);
+  for (std::size_t i = 0; i < n; ++i) r.d[i] = f1 * a.d[i];
+  return r;
+}
+template<std::size_t n > inline dual<n > exp(const dual<n >& a) {
+  const double e = std::exp(a.v);
+  return chain(a, e, e);
+}
+template<std::size_t n > inline dual<n > log(const dual<n >& a) {return chain(a, std::log(a.v), 1.0 / a.v);}
+template<std::size_t n > inline dual<n > log1p(const dual<n >& a) {return chain(a, std::log1p(a.v), 1.0 / (1.0 + a.v));}
+template<std::size_t n > inline dual<n > sqrt(const dual<n >& a) {
+  const double s = std::sqrt(a.v);
+  return chain(a, s, 0.5 / s);
+}
+
+/**
+ * \returns the value of a scalar without derivatives
+ */
+inline double value_of(const double x) {return x;}
+template<std::size_t n > inline double value_of(const dual<n >& x) {return x.v;}
+
+template<std::size_t n > inline dual<n > back(const std::vector<dual<n > >& vec) {return vec.back();}
+
+#endif //GUTS_DUAL_H
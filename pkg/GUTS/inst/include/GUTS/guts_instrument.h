@@ -0,0 +1,144 @@
+/**
+ * GUTS: Fast Calculation of the Likelihood of a Stochastic Survival Model.
+ * soeren.vogel@posteo.ch, carlo.albert@eawag.ch, alexander singer@rifcon.de, oliver.jakoby@rifcon.de, dirk.nickisch@rifcon.de
+ * License GPL-2
+ * 2026-10-19
+ */
+
+#ifndef GUTS_INSTRUMENT_H
+#define GUTS_INSTRUMENT_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * \brief Counted events of the hot path
+ *   - calculate_damage: solutions of the TK equation
+ *   - gather_effect: damage values gathered by TDs
+ *   - survival: survival calculations of projections (calculate_current_survival and the log-scale variant)
+ *   - bin_walk: steps of the search for the threshold bin in TD_proper_base::gather_effect
+ *   - time_steps: steps on the time grid of time-discrete projections
+ *   - allocations: buffers sized by the initialization of projectors and threshold bins
+ */
+enum class instrument_counter : std::size_t {
+  calculate_damage = 0,
+  gather_effect,
+  survival,
+  bin_walk,
+  time_steps,
+  allocations,
+  n
+};
+
+/**
+ * \brief Timed phases of an evaluation
+ *   - setup: data of projectors (add_data, initialize)
+ *   - sample: generation of threshold samples (calc_sample)
+ *   - projection: TK and TD between survival times
+ *   - survival: survival at the survival times
+ *   - loglikelihood: loglikelihood from survival
+ *   - reporting: results written to GUTS objects
+ * Phases do not nest.
+ */
+enum class instrument_phase : std::size_t {
+  setup = 0,
+  sample,
+  projection,
+  survival,
+  loglikelihood,
+  reporting,
+  n
+};
+
+/**
+ * \brief Sum of the profiles of all threads
+ */
+struct guts_instrument_totals {
+  std::array<std::uint64_t, static_cast<std::size_t >(instrument_counter::n) > counts;
+  std::array<std::uint64_t, static_cast<std::size_t >(instrument_phase::n) > calls;
+  std::array<double, static_cast<std::size_t >(instrument_phase::n) > seconds;
+};
+
+/**
+ * \returns true if the package was compiled with GUTS_INSTRUMENT
+ */
+bool guts_instrument_enabled();
+/**
+ * \returns the sum of the profiles of all threads, including finished threads; zeros without GUTS_INSTRUMENT
+ */
+guts_instrument_totals guts_instrument_collect();
+/**
+ * \brief Set all profiles to zero
+ * \details Counts of threads that evaluate concurrently may be lost.
+ */
+void guts_instrument_reset();
+
+#ifdef GUTS_INSTRUMENT
+
+#include <atomic>
+#include <chrono>
+
+/**
+ * \brief Profile of one thread
+ * \details Only the owning thread writes (relaxed load and store, no locked instructions),
+ * guts_instrument_collect() reads from any thread.
+ */
+struct guts_thread_instrument {
+  std::array<std::atomic<std::uint64_t >, static_cast<std::size_t >(instrument_counter::n) > counts;
+  std::array<std::atomic<std::uint64_t >, static_cast<std::size_t >(instrument_phase::n) > calls;
+  std::array<std::atomic<std::uint64_t >, static_cast<std::size_t >(instrument_phase::n) > nanoseconds;
+};
+
+/**
+ * \returns the profile of the calling thread, registered until the thread finishes
+ */
+guts_thread_instrument* guts_register_thread_instrument();
+
+/**
+ * \returns the profile of the calling thread, registered on first use
+ */
+inline guts_thread_instrument& guts_this_thread_instrument() {
+  static thread_local guts_thread_instrument* profile = guts_register_thread_instrument();
+  return *profile;
+}
+
+inline void guts_instrument_add(std::atomic<std::uint64_t >& a, const std::uint64_t n) {
+  a.store(a.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+inline void guts_instrument_count(const instrument_counter counter, const std::uint64_t n) {
+  guts_instrument_add(guts_this_thread_instrument().counts[static_cast<std::size_t >(counter)], n);
+}
+
+/**
+ * \brief Adds the time from construction to destruction to a phase
+ */
+class guts_instrument_scope {
+public:
+  explicit guts_instrument_scope(const instrument_phase new_phase) :
+    phase(static_cast<std::size_t >(new_phase)), start(std::chrono::steady_clock::now()) {}
+  ~guts_instrument_scope() {
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds >(std::chrono::steady_clock::now() - start).count();
+    guts_thread_instrument& profile = guts_this_thread_instrument();
+    guts_instrument_add(profile.calls[phase], 1);
+    guts_instrument_add(profile.nanoseconds[phase], static_cast<std::uint64_t >(ns));
+  }
+  guts_instrument_scope(const guts_instrument_scope&) = delete;
+  guts_instrument_scope& operator=(const guts_instrument_scope&) = delete;
+private:
+  const std::size_t phase;
+  const std::chrono::steady_clock::time_point start;
+};
+
+#define GUTS_INSTRUMENT_COUNT(counter, n) guts_instrument_count(instrument_counter::counter, (n))
+#define GUTS_INSTRUMENT_SCOPE(phase) guts_instrument_scope guts_instrument_scope_##phase(instrument_phase::phase)
+
+#else
+
+#define GUTS_INSTRUMENT_COUNT(counter, n) ((void)0)
+#define GUTS_INSTRUMENT_SCOPE(phase) ((void)0)
+
+#endif //GUTS_INSTRUMENT
+
+#endif //GUTS_INSTRUMENT_H
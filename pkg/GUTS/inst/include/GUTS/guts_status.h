@@ -0,0 +1,82 @@
+/**
+ * GUTS: Fast Calculation of the Likelihood of a Stochastic Survival Model.
+ * soeren.vogel@posteo.ch, carlo.albert@eawag.ch, alexander singer@rifcon.de, oliver.jakoby@rifcon.de, dirk.nickisch@rifcon.de
+ * License GPL-2
+ * 2026-10-19
+ */
+
+#ifndef GUTS_STATUS_H
+#define GUTS_STATUS_H
+
+#include <stdexcept>
+
+/**
+ * @brief Reason codes for numerical failures of a projection
+ *
+ * @details Projections report failures as status codes instead of exceptions,
+ * such that samplers and optimizers can treat extreme parameter proposals as
+ * impossible (LL = -Inf) without unwinding the stack.
+ * guts_engine reports them as named integer in the field "status" of GUTS objects.
+ */
+enum class guts_status : int {
+	ok = 0,
+	survival_underflow = 1,
+	lognormal_incomplete = 2,
+	lognormal_infinite_variates = 3,
+	loglogistic_scale_not_positive = 4,
+	loglogistic_shape_not_positive = 5,
+	loglogistic_shape_not_above_one = 6,
+	loglogistic_infinite_variates = 7,
+	rejected_early = 8
+};
+
+/**
+ * @returns a short label for the status code
+ */
+inline const char* status_label(const guts_status status) {
+	switch (status) {
+	case guts_status::ok : return "ok";
+	case guts_status::survival_underflow : return "survival_underflow";
+	case guts_status::lognormal_incomplete : return "lognormal_incomplete";
+	case guts_status::lognormal_infinite_variates : return "lognormal_infinite_variates";
+	case guts_status::loglogistic_scale_not_positive : return "loglogistic_scale_not_positive";
+	case guts_status::loglogistic_shape_not_positive : return "loglogistic_shape_not_positive";
+	case guts_status::loglogistic_shape_not_above_one : return "loglogistic_shape_not_above_one";
+	case guts_status::loglogistic_infinite_variates : return "loglogistic_infinite_variates";
+	case guts_status::rejected_early : return "rejected_early";
+	}
+	return "unknown";
+}
+
+/**
+ * @brief Throw the exception that corresponds to a status code
+ *
+ * @details Used by the throwing interfaces (e.g. calc_sample(), project_survival())
+ * to keep their original exception types and messages.
+ * Does nothing if status is guts_status::ok or guts_status::rejected_early,
+ * which is no failure but reports a projection stopped below a loglikelihood bound.
+ */
+inline void throw_on_status(const guts_status status) {
+	switch (status) {
+	case guts_status::ok :
+	case guts_status::rejected_early :
+		return;
+	case guts_status::survival_underflow :
+		throw std::underflow_error("Numeric underflow: Survival cannot be calculated for given parameter values." );
+	case guts_status::lognormal_incomplete :
+		throw std::domain_error( "mn = 0 and sd != 0 -- incomplete lognormal model ignored." );
+	case guts_status::lognormal_infinite_variates :
+		throw std::overflow_error( "Approximating lognormal distribution: infinite variates. Please check parameter values." );
+	case guts_status::loglogistic_scale_not_positive :
+		throw std::domain_error( "Loglogistic distribution undefined for scale parameter <= 0. \nPlease check parameter values." );
+	case guts_status::loglogistic_shape_not_positive :
+		throw std::domain_error( "Loglogistic distribution undefined for shape parameter <= 0. \nPlease check parameter values." );
+	case guts_status::loglogistic_shape_not_above_one :
+		throw std::domain_error( "Approximating loglogistic distribution: \nShape parameter should be above 1 to avoid an unrealistic concentration threshold distribution that peaks at 0. A concentration threshold close to 0 is better described by a scale parameter that approximates 0. \nNummeric approximation might be wrong. Please check parameter values." );
+	case guts_status::loglogistic_infinite_variates :
+		throw std::domain_error( "Approximating loglogistic distribution: infinite variates. \nPlease check parameter values." );
+	}
+	throw std::runtime_error("Unknown GUTS status code.");
+}
+
+#endif //GUTS_STATUS_H
@@ -0,0 +1,68 @@
+/**
+ * GUTS: Fast Calculation of the Likelihood of a Stochastic Survival Model.
+ * soeren.vogel@posteo.ch, carlo.albert@eawag.ch, alexander singer@rifcon.de, oliver.jakoby@rifcon.de, dirk.nickisch@rifcon.de
+ * License GPL-2
+ * 2021-11-30 
+ * updated: 2026-10-19
+ */
+
+#ifndef HELPERS_H
+#define HELPERS_H
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief first and last element of vectors with at() and size() (e.g. Rcpp vectors)
+ *
+ * @details Generic, such that the models do not depend on Rcpp.
+ */
+template<typename tVec >
+inline auto back(const tVec& vec) -> typename std::decay<decltype(vec.at(0))>::type {return vec.at(vec.size()-1);}
+template<typename tVec >
+inline auto front(const tVec& vec) -> typename std::decay<decltype(vec.at(0))>::type {return vec.at(0);}
+inline int back(const std::vector<int >& vec) {return vec.back();}
+inline int front(const std::vector<int >& vec) {return vec.front();}
+inline double back(const std::vector<double >& vec) {return vec.back();}
+inline double front(const std::vector<double >& vec) {return vec.front();}
+
+/**
+ * @brief add exp(a) to a sum that is stored as exp(a_max) * S
+ *
+ * @details Accumulates log(sum(exp(a))) in a single pass without over- or underflow.
+ * Start with a_max = -Inf and S = 0; the result is a_max + log(S).
+ * tScalar is double, or dual numbers for derivatives (see guts_dual.h).
+ */
+template<typename tScalar >
+inline void add_to_log_sum_exp(const tScalar& a, tScalar& a_max, tScalar& S) {
+  using std::exp;
+  if (a == -std::numeric_limits<double>::infinity()) return;
+  if (a <= a_max) {
+    S += exp(a - a_max);
+  } else {
+    S = S * exp(a_max - a) + 1.0;
+    a_max = a;
+  }
+}
+
+/**
+ * @brief sum in double with compensation of rounding errors (Neumaier)
+ *
+ * @details Used to accumulate many terms of single precision without loss of accuracy.
+ */
+struct compensated_sum {
+  double sum;
+  double c;
+  compensated_sum(const double x = 0.0) : sum(x), c(0.0) {}
+  inline compensated_sum& operator+=(const double x) {
+    const double t = sum + x;
+    c += std::fabs(sum) >= std::fabs(x) ? (sum - t) + x : (x - t) + sum;
+    sum = t;
+    return *this;
+  }
+  inline operator double() const {return sum + c;}
+};
+
+#endif
\ No newline at end of file
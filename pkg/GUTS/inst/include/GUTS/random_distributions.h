@@ -0,0 +1,105 @@
+/**
+ * GUTS: Fast Calculation of the Likelihood of a Stochastic Survival Model.
+ * soeren.vogel@posteo.ch, carlo.albert@eawag.ch, alexander singer@rifcon.de, oliver.jakoby@rifcon.de, dirk.nickisch@rifcon.de
+ * License GPL-2
+ * 2017-10-09 
+ * updated: 2019-01-29
+ * updated: 2021-11-30
+ * updated: 2022-01-17 
+ * updated: 2026-10-19
+ */
+
+
+#ifndef RANDOM_DISTRIBUTIONS_H
+#define RANDOM_DISTRIBUTIONS_H
+
+#include <limits>
+#include <vector>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+#include "external_data.h"
+
+struct distribution {
+	virtual ~distribution() {}
+	virtual double CDF(const double x) const = 0;
+};
+
+/**
+ * @tparam tScalar numeric type of the parameters (double, or dual numbers for derivatives, see guts_dual.h)
+ */
+template<typename tScalar = double >
+struct basic_lognormal_parameters {
+  basic_lognormal_parameters() :
+  mn(std::numeric_limits<double>::quiet_NaN()),
+  sd(std::numeric_limits<double>::quiet_NaN())
+  {}
+  virtual ~basic_lognormal_parameters() {}
+  inline void set_threshold_mean(const tScalar new_mn) {mn = new_mn;}
+  inline void set_threshold_sd(const tScalar new_sd) {sd = new_sd;}
+  inline tScalar get_threshold_mean() const {return mn;}
+  inline tScalar get_threshold_sd() const {return sd;}
+    protected:
+    tScalar mn;
+    tScalar sd;
+};
+typedef basic_lognormal_parameters<> lognormal_parameters;
+
+struct lognormal :
+		virtual public distribution,
+		virtual public lognormal_parameters
+		{
+	virtual ~lognormal() {}
+	inline double CDF(const double x) const final {
+	  double sigma_square = std::log((sd * sd) / mn / mn + 1);
+	  double mu = std::log(mn) - sigma_square / 2;
+		return 0.5 + std::erf( (std::log(x)-mu)/std::sqrt(2 * sigma_square) ) / 2;
+	}
+};
+
+template<typename tScalar = double >
+class basic_loglogistic_parameters {
+public:
+  basic_loglogistic_parameters() :
+  alpha(std::numeric_limits<double>::quiet_NaN()),
+  beta(std::numeric_limits<double>::quiet_NaN())
+{}
+  virtual ~basic_loglogistic_parameters() {}
+  inline void set_threshold_alpha(const tScalar new_alpha) {alpha = new_alpha;}
+  inline void set_threshold_beta(const tScalar new_beta) {beta = new_beta;}
+  inline tScalar get_threshold_alpha() const {return alpha;}
+  inline tScalar get_threshold_beta() const {return beta;}
+protected:
+  tScalar alpha;
+  tScalar beta;
+};
+typedef basic_loglogistic_parameters<> loglogistic_parameters;
+
+struct loglogistic :
+		virtual public distribution,
+		virtual public loglogistic_parameters
+		{
+	virtual ~loglogistic() {}
+	inline double CDF(const double x) const final {
+		return 1/(1+std::pow(x/alpha,-beta));
+	}
+};
+
+template<typename tScalar = double >
+class basic_delta_parameters {
+public:
+  basic_delta_parameters() :
+  z_val(std::numeric_limits<double>::quiet_NaN())
+{}
+  virtual ~basic_delta_parameters() {}
+  inline void set_threshold(const tScalar threshold){
+    z_val = threshold;
+  }
+  inline tScalar get_threshold() const {return z_val;}
+protected:
+  tScalar z_val;
+};
+typedef basic_delta_parameters<> delta_parameters;
+
+#endif //TD_SAMPLERS_H
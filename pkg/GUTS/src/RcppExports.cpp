@@ -11,20 +11,351 @@ Rcpp::Rostream<false>& Rcpp::Rcerr = Rcpp::Rcpp_cerr_get();
 #endif
 
 // guts_engine
-void guts_engine(Rcpp::List gobj, Rcpp::NumericVector par, Rcpp::Nullable<Rcpp::NumericVector > z_dist);
-RcppExport SEXP _GUTS_guts_engine(SEXP gobjSEXP, SEXP parSEXP, SEXP z_distSEXP) {
+void guts_engine(Rcpp::List gobj, Rcpp::NumericVector par, Rcpp::Nullable<Rcpp::NumericVector > z_dist, bool stop_on_failure, double LL_lower_bound);
+RcppExport SEXP _GUTS_guts_engine(SEXP gobjSEXP, SEXP parSEXP, SEXP z_distSEXP, SEXP stop_on_failureSEXP, SEXP LL_lower_boundSEXP) {
 BEGIN_RCPP
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< Rcpp::List >::type gobj(gobjSEXP);
     Rcpp::traits::input_parameter< Rcpp::NumericVector >::type par(parSEXP);
     Rcpp::traits::input_parameter< Rcpp::Nullable<Rcpp::NumericVector > >::type z_dist(z_distSEXP);
-    guts_engine(gobj, par, z_dist);
+    Rcpp::traits::input_parameter< bool >::type stop_on_failure(stop_on_failureSEXP);
+    Rcpp::traits::input_parameter< double >::type LL_lower_bound(LL_lower_boundSEXP);
+    guts_engine(gobj, par, z_dist, stop_on_failure, LL_lower_bound);
     return R_NilValue;
 END_RCPP
 }
 
+// guts_cache_create
+SEXP guts_cache_create(int cache_size);
+RcppExport SEXP _GUTS_guts_cache_create(SEXP cache_sizeSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< int >::type cache_size(cache_sizeSEXP);
+    rcpp_result_gen = Rcpp::wrap(guts_cache_create(cache_size));
+    return rcpp_result_gen;
+END_RCPP
+}
+
+// guts_cache_report
+Rcpp::NumericVector guts_cache_report(Rcpp::List gobj);
+RcppExport SEXP _GUTS_guts_cache_report(SEXP gobjSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::List >::type gobj(gobjSEXP);
+    rcpp_result_gen = Rcpp::wrap(guts_cache_report(gobj));
+    return rcpp_result_gen;
+END_RCPP
+}
+
+// guts_instrument_report
+Rcpp::List guts_instrument_report();
+RcppExport SEXP _GUTS_guts_instrument_report() {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    rcpp_result_gen = Rcpp::wrap(guts_instrument_report());
+    return rcpp_result_gen;
+END_RCPP
+}
+
+// guts_instrument_clear
+void guts_instrument_clear();
+RcppExport SEXP _GUTS_guts_instrument_clear() {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    guts_instrument_clear();
+    return R_NilValue;
+END_RCPP
+}
+
+// guts_lpx_engine
+Rcpp::NumericMatrix guts_lpx_engine(Rcpp::List gobj, Rcpp::NumericMatrix par, Rcpp::NumericVector effects, double tol, int n_threads, Rcpp::Nullable<Rcpp::NumericVector > z_dist);
+RcppExport SEXP _GUTS_guts_lpx_engine(SEXP gobjSEXP, SEXP parSEXP, SEXP effectsSEXP, SEXP tolSEXP, SEXP n_threadsSEXP, SEXP z_distSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::List >::type gobj(gobjSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericMatrix >::type par(parSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type effects(effectsSEXP);
+    Rcpp::traits::input_parameter< double >::type tol(tolSEXP);
+    Rcpp::traits::input_parameter< int >::type n_threads(n_threadsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::Nullable<Rcpp::NumericVector > >::type z_dist(z_distSEXP);
+    rcpp_result_gen = Rcpp::wrap(guts_lpx_engine(gobj, par, effects, tol, n_threads, z_dist));
+    return rcpp_result_gen;
+END_RCPP
+}
+// guts_constant_exposure_engine
+Rcpp::NumericVector guts_constant_exposure_engine(Rcpp::List gobj, Rcpp::NumericMatrix par, Rcpp::NumericVector conc, Rcpp::NumericVector t, int n_threads, Rcpp::Nullable<Rcpp::NumericVector > z_dist);
+RcppExport SEXP _GUTS_guts_constant_exposure_engine(SEXP gobjSEXP, SEXP parSEXP, SEXP concSEXP, SEXP tSEXP, SEXP n_threadsSEXP, SEXP z_distSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::List >::type gobj(gobjSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericMatrix >::type par(parSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type conc(concSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type t(tSEXP);
+    Rcpp::traits::input_parameter< int >::type n_threads(n_threadsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::Nullable<Rcpp::NumericVector > >::type z_dist(z_distSEXP);
+    rcpp_result_gen = Rcpp::wrap(guts_constant_exposure_engine(gobj, par, conc, t, n_threads, z_dist));
+    return rcpp_result_gen;
+END_RCPP
+}
+// guts_lcx_engine
+Rcpp::NumericVector guts_lcx_engine(Rcpp::List gobj, Rcpp::NumericMatrix par, Rcpp::NumericVector effects, Rcpp::NumericVector t, double tol, int n_threads, Rcpp::Nullable<Rcpp::NumericVector > z_dist);
+RcppExport SEXP _GUTS_guts_lcx_engine(SEXP gobjSEXP, SEXP parSEXP, SEXP effectsSEXP, SEXP tSEXP, SEXP tolSEXP, SEXP n_threadsSEXP, SEXP z_distSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::List >::type gobj(gobjSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericMatrix >::type par(parSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type effects(effectsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type t(tSEXP);
+    Rcpp::traits::input_parameter< double >::type tol(tolSEXP);
+    Rcpp::traits::input_parameter< int >::type n_threads(n_threadsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::Nullable<Rcpp::NumericVector > >::type z_dist(z_distSEXP);
+    rcpp_result_gen = Rcpp::wrap(guts_lcx_engine(gobj, par, effects, t, tol, n_threads, z_dist));
+    return rcpp_result_gen;
+END_RCPP
+}
+// guts_window_scan_engine
+Rcpp::List guts_window_scan_engine(Rcpp::List gobj, Rcpp::NumericVector par, Rcpp::NumericVector Ct, Rcpp::NumericVector C, double window, Rcpp::NumericVector starts, Rcpp::NumericVector effects, double tol, int n_threads, Rcpp::Nullable<Rcpp::NumericVector > z_dist);
+RcppExport SEXP _GUTS_guts_window_scan_engine(SEXP gobjSEXP, SEXP parSEXP, SEXP CtSEXP, SEXP CSEXP, SEXP windowSEXP, SEXP startsSEXP, SEXP effectsSEXP, SEXP tolSEXP, SEXP n_threadsSEXP, SEXP z_distSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::List >::type gobj(gobjSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type par(parSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type Ct(CtSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type C(CSEXP);
+    Rcpp::traits::input_parameter< double >::type window(windowSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type starts(startsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type effects(effectsSEXP);
+    Rcpp::traits::input_parameter< double >::type tol(tolSEXP);
+    Rcpp::traits::input_parameter< int >::type n_threads(n_threadsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::Nullable<Rcpp::NumericVector > >::type z_dist(z_distSEXP);
+    rcpp_result_gen = Rcpp::wrap(guts_window_scan_engine(gobj, par, Ct, C, window, starts, effects, tol, n_threads, z_dist));
+    return rcpp_result_gen;
+END_RCPP
+}
+// guts_exposure_batch_engine
+SEXP guts_exposure_batch_engine(Rcpp::List gobj, Rcpp::NumericMatrix par, Rcpp::List Ct, Rcpp::List C, double dtau, Rcpp::NumericVector effects, double tol, int n_threads, std::string file, Rcpp::Nullable<Rcpp::NumericVector > z_dist);
+RcppExport SEXP _GUTS_guts_exposure_batch_engine(SEXP gobjSEXP, SEXP parSEXP, SEXP CtSEXP, SEXP CSEXP, SEXP dtauSEXP, SEXP effectsSEXP, SEXP tolSEXP, SEXP n_threadsSEXP, SEXP fileSEXP, SEXP z_distSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::List >::type gobj(gobjSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericMatrix >::type par(parSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type Ct(CtSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type C(CSEXP);
+    Rcpp::traits::input_parameter< double >::type dtau(dtauSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type effects(effectsSEXP);
+    Rcpp::traits::input_parameter< double >::type tol(tolSEXP);
+    Rcpp::traits::input_parameter< int >::type n_threads(n_threadsSEXP);
+    Rcpp::traits::input_parameter< std::string >::type file(fileSEXP);
+    Rcpp::traits::input_parameter< Rcpp::Nullable<Rcpp::NumericVector > >::type z_dist(z_distSEXP);
+    rcpp_result_gen = Rcpp::wrap(guts_exposure_batch_engine(gobj, par, Ct, C, dtau, effects, tol, n_threads, file, z_dist));
+    return rcpp_result_gen;
+END_RCPP
+}
+// guts_survival_batch_engine
+double guts_survival_batch_engine(Rcpp::List gobjs, Rcpp::NumericMatrix par, std::string file, int n_threads, Rcpp::Nullable<Rcpp::NumericVector > z_dist);
+RcppExport SEXP _GUTS_guts_survival_batch_engine(SEXP gobjsSEXP, SEXP parSEXP, SEXP fileSEXP, SEXP n_threadsSEXP, SEXP z_distSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::List >::type gobjs(gobjsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericMatrix >::type par(parSEXP);
+    Rcpp::traits::input_parameter< std::string >::type file(fileSEXP);
+    Rcpp::traits::input_parameter< int >::type n_threads(n_threadsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::Nullable<Rcpp::NumericVector > >::type z_dist(z_distSEXP);
+    rcpp_result_gen = Rcpp::wrap(guts_survival_batch_engine(gobjs, par, file, n_threads, z_dist));
+    return rcpp_result_gen;
+END_RCPP
+}
+// guts_mcmc_engine
+Rcpp::List guts_mcmc_engine(Rcpp::List gobjs, Rcpp::NumericMatrix init, Rcpp::NumericMatrix scale, Rcpp::NumericVector lower, Rcpp::NumericVector upper, int n, int adapt, double acc_rate, double gamma, bool early_rejection, double seed, int n_threads, Rcpp::Nullable<Rcpp::NumericVector > z_dist, double coarse_factor);
+RcppExport SEXP _GUTS_guts_mcmc_engine(SEXP gobjsSEXP, SEXP initSEXP, SEXP scaleSEXP, SEXP lowerSEXP, SEXP upperSEXP, SEXP nSEXP, SEXP adaptSEXP, SEXP acc_rateSEXP, SEXP gammaSEXP, SEXP early_rejectionSEXP, SEXP seedSEXP, SEXP n_threadsSEXP, SEXP z_distSEXP, SEXP coarse_factorSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::List >::type gobjs(gobjsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericMatrix >::type init(initSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericMatrix >::type scale(scaleSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type lower(lowerSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type upper(upperSEXP);
+    Rcpp::traits::input_parameter< int >::type n(nSEXP);
+    Rcpp::traits::input_parameter< int >::type adapt(adaptSEXP);
+    Rcpp::traits::input_parameter< double >::type acc_rate(acc_rateSEXP);
+    Rcpp::traits::input_parameter< double >::type gamma(gammaSEXP);
+    Rcpp::traits::input_parameter< bool >::type early_rejection(early_rejectionSEXP);
+    Rcpp::traits::input_parameter< double >::type seed(seedSEXP);
+    Rcpp::traits::input_parameter< int >::type n_threads(n_threadsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::Nullable<Rcpp::NumericVector > >::type z_dist(z_distSEXP);
+    Rcpp::traits::input_parameter< double >::type coarse_factor(coarse_factorSEXP);
+    rcpp_result_gen = Rcpp::wrap(guts_mcmc_engine(gobjs, init, scale, lower, upper, n, adapt, acc_rate, gamma, early_rejection, seed, n_threads, z_dist, coarse_factor));
+    return rcpp_result_gen;
+END_RCPP
+}
+
+// guts_ensemble_engine
+Rcpp::List guts_ensemble_engine(Rcpp::List gobjs, Rcpp::NumericMatrix init, Rcpp::NumericVector lower, Rcpp::NumericVector upper, int n, double a, bool early_rejection, double seed, int n_threads, Rcpp::Nullable<Rcpp::NumericVector > z_dist);
+RcppExport SEXP _GUTS_guts_ensemble_engine(SEXP gobjsSEXP, SEXP initSEXP, SEXP lowerSEXP, SEXP upperSEXP, SEXP nSEXP, SEXP aSEXP, SEXP early_rejectionSEXP, SEXP seedSEXP, SEXP n_threadsSEXP, SEXP z_distSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::List >::type gobjs(gobjsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericMatrix >::type init(initSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type lower(lowerSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type upper(upperSEXP);
+    Rcpp::traits::input_parameter< int >::type n(nSEXP);
+    Rcpp::traits::input_parameter< double >::type a(aSEXP);
+    Rcpp::traits::input_parameter< bool >::type early_rejection(early_rejectionSEXP);
+    Rcpp::traits::input_parameter< double >::type seed(seedSEXP);
+    Rcpp::traits::input_parameter< int >::type n_threads(n_threadsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::Nullable<Rcpp::NumericVector > >::type z_dist(z_distSEXP);
+    rcpp_result_gen = Rcpp::wrap(guts_ensemble_engine(gobjs, init, lower, upper, n, a, early_rejection, seed, n_threads, z_dist));
+    return rcpp_result_gen;
+END_RCPP
+}
+
+// guts_fit_engine
+Rcpp::List guts_fit_engine(Rcpp::List gobjs, Rcpp::NumericVector init, Rcpp::NumericVector lower, Rcpp::NumericVector upper, int maxit, double factr, double pgtol, double fd_step, bool hessian, int n_threads, Rcpp::Nullable<Rcpp::NumericVector > z_dist);
+RcppExport SEXP _GUTS_guts_fit_engine(SEXP gobjsSEXP, SEXP initSEXP, SEXP lowerSEXP, SEXP upperSEXP, SEXP maxitSEXP, SEXP factrSEXP, SEXP pgtolSEXP, SEXP fd_stepSEXP, SEXP hessianSEXP, SEXP n_threadsSEXP, SEXP z_distSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::List >::type gobjs(gobjsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type init(initSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type lower(lowerSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type upper(upperSEXP);
+    Rcpp::traits::input_parameter< int >::type maxit(maxitSEXP);
+    Rcpp::traits::input_parameter< double >::type factr(factrSEXP);
+    Rcpp::traits::input_parameter< double >::type pgtol(pgtolSEXP);
+    Rcpp::traits::input_parameter< double >::type fd_step(fd_stepSEXP);
+    Rcpp::traits::input_parameter< bool >::type hessian(hessianSEXP);
+    Rcpp::traits::input_parameter< int >::type n_threads(n_threadsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::Nullable<Rcpp::NumericVector > >::type z_dist(z_distSEXP);
+    rcpp_result_gen = Rcpp::wrap(guts_fit_engine(gobjs, init, lower, upper, maxit, factr, pgtol, fd_step, hessian, n_threads, z_dist));
+    return rcpp_result_gen;
+END_RCPP
+}
+
+// guts_fit_global_engine
+Rcpp::List guts_fit_global_engine(Rcpp::List gobjs, Rcpp::Nullable<Rcpp::NumericVector > init, Rcpp::NumericVector lower, Rcpp::NumericVector upper, int n_pop, int max_gen, double F, double CR, double reltol, double seed, int n_threads, Rcpp::Nullable<Rcpp::NumericVector > z_dist);
+RcppExport SEXP _GUTS_guts_fit_global_engine(SEXP gobjsSEXP, SEXP initSEXP, SEXP lowerSEXP, SEXP upperSEXP, SEXP n_popSEXP, SEXP max_genSEXP, SEXP FSEXP, SEXP CRSEXP, SEXP reltolSEXP, SEXP seedSEXP, SEXP n_threadsSEXP, SEXP z_distSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::List >::type gobjs(gobjsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::Nullable<Rcpp::NumericVector > >::type init(initSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type lower(lowerSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type upper(upperSEXP);
+    Rcpp::traits::input_parameter< int >::type n_pop(n_popSEXP);
+    Rcpp::traits::input_parameter< int >::type max_gen(max_genSEXP);
+    Rcpp::traits::input_parameter< double >::type F(FSEXP);
+    Rcpp::traits::input_parameter< double >::type CR(CRSEXP);
+    Rcpp::traits::input_parameter< double >::type reltol(reltolSEXP);
+    Rcpp::traits::input_parameter< double >::type seed(seedSEXP);
+    Rcpp::traits::input_parameter< int >::type n_threads(n_threadsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::Nullable<Rcpp::NumericVector > >::type z_dist(z_distSEXP);
+    rcpp_result_gen = Rcpp::wrap(guts_fit_global_engine(gobjs, init, lower, upper, n_pop, max_gen, F, CR, reltol, seed, n_threads, z_dist));
+    return rcpp_result_gen;
+END_RCPP
+}
+// guts_gradient_engine
+Rcpp::NumericVector guts_gradient_engine(Rcpp::List gobjs, Rcpp::NumericVector par, Rcpp::Nullable<Rcpp::NumericVector > z_dist);
+RcppExport SEXP _GUTS_guts_gradient_engine(SEXP gobjsSEXP, SEXP parSEXP, SEXP z_distSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::List >::type gobjs(gobjsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type par(parSEXP);
+    Rcpp::traits::input_parameter< Rcpp::Nullable<Rcpp::NumericVector > >::type z_dist(z_distSEXP);
+    rcpp_result_gen = Rcpp::wrap(guts_gradient_engine(gobjs, par, z_dist));
+    return rcpp_result_gen;
+END_RCPP
+}
+// guts_profile_engine
+Rcpp::List guts_profile_engine(Rcpp::List gobjs, Rcpp::NumericVector estimate, double LL_max, Rcpp::IntegerVector which, Rcpp::NumericVector lower, Rcpp::NumericVector upper, Rcpp::NumericVector step, double LL_drop, int max_steps, int maxit, double factr, double pgtol, double fd_step, int n_threads, Rcpp::Nullable<Rcpp::NumericVector > z_dist);
+RcppExport SEXP _GUTS_guts_profile_engine(SEXP gobjsSEXP, SEXP estimateSEXP, SEXP LL_maxSEXP, SEXP whichSEXP, SEXP lowerSEXP, SEXP upperSEXP, SEXP stepSEXP, SEXP LL_dropSEXP, SEXP max_stepsSEXP, SEXP maxitSEXP, SEXP factrSEXP, SEXP pgtolSEXP, SEXP fd_stepSEXP, SEXP n_threadsSEXP, SEXP z_distSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::List >::type gobjs(gobjsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type estimate(estimateSEXP);
+    Rcpp::traits::input_parameter< double >::type LL_max(LL_maxSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type which(whichSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type lower(lowerSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type upper(upperSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type step(stepSEXP);
+    Rcpp::traits::input_parameter< double >::type LL_drop(LL_dropSEXP);
+    Rcpp::traits::input_parameter< int >::type max_steps(max_stepsSEXP);
+    Rcpp::traits::input_parameter< int >::type maxit(maxitSEXP);
+    Rcpp::traits::input_parameter< double >::type factr(factrSEXP);
+    Rcpp::traits::input_parameter< double >::type pgtol(pgtolSEXP);
+    Rcpp::traits::input_parameter< double >::type fd_step(fd_stepSEXP);
+    Rcpp::traits::input_parameter< int >::type n_threads(n_threadsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::Nullable<Rcpp::NumericVector > >::type z_dist(z_distSEXP);
+    rcpp_result_gen = Rcpp::wrap(guts_profile_engine(gobjs, estimate, LL_max, which, lower, upper, step, LL_drop, max_steps, maxit, factr, pgtol, fd_step, n_threads, z_dist));
+    return rcpp_result_gen;
+END_RCPP
+}
+// guts_simulate_engine
+Rcpp::IntegerMatrix guts_simulate_engine(Rcpp::List gobj, Rcpp::NumericMatrix par, int n_rep, int n0, double seed, int n_threads, Rcpp::Nullable<Rcpp::NumericVector > z_dist);
+RcppExport SEXP _GUTS_guts_simulate_engine(SEXP gobjSEXP, SEXP parSEXP, SEXP n_repSEXP, SEXP n0SEXP, SEXP seedSEXP, SEXP n_threadsSEXP, SEXP z_distSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::List >::type gobj(gobjSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericMatrix >::type par(parSEXP);
+    Rcpp::traits::input_parameter< int >::type n_rep(n_repSEXP);
+    Rcpp::traits::input_parameter< int >::type n0(n0SEXP);
+    Rcpp::traits::input_parameter< double >::type seed(seedSEXP);
+    Rcpp::traits::input_parameter< int >::type n_threads(n_threadsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::Nullable<Rcpp::NumericVector > >::type z_dist(z_distSEXP);
+    rcpp_result_gen = Rcpp::wrap(guts_simulate_engine(gobj, par, n_rep, n0, seed, n_threads, z_dist));
+    return rcpp_result_gen;
+END_RCPP
+}
+// guts_predictive_bands_engine
+Rcpp::List guts_predictive_bands_engine(Rcpp::List gobj, Rcpp::NumericMatrix par, Rcpp::NumericVector probs, double compression, int n_threads, Rcpp::Nullable<Rcpp::NumericVector > z_dist);
+RcppExport SEXP _GUTS_guts_predictive_bands_engine(SEXP gobjSEXP, SEXP parSEXP, SEXP probsSEXP, SEXP compressionSEXP, SEXP n_threadsSEXP, SEXP z_distSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::List >::type gobj(gobjSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericMatrix >::type par(parSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type probs(probsSEXP);
+    Rcpp::traits::input_parameter< double >::type compression(compressionSEXP);
+    Rcpp::traits::input_parameter< int >::type n_threads(n_threadsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::Nullable<Rcpp::NumericVector > >::type z_dist(z_distSEXP);
+    rcpp_result_gen = Rcpp::wrap(guts_predictive_bands_engine(gobj, par, probs, compression, n_threads, z_dist));
+    return rcpp_result_gen;
+END_RCPP
+}
+
 static const R_CallMethodDef CallEntries[] = {
-    {"_GUTS_guts_engine", (DL_FUNC) &_GUTS_guts_engine, 3},
+    {"_GUTS_guts_engine", (DL_FUNC) &_GUTS_guts_engine, 5},
+    {"_GUTS_guts_cache_create", (DL_FUNC) &_GUTS_guts_cache_create, 1},
+    {"_GUTS_guts_cache_report", (DL_FUNC) &_GUTS_guts_cache_report, 1},
+    {"_GUTS_guts_instrument_report", (DL_FUNC) &_GUTS_guts_instrument_report, 0},
+    {"_GUTS_guts_instrument_clear", (DL_FUNC) &_GUTS_guts_instrument_clear, 0},
+    {"_GUTS_guts_lpx_engine", (DL_FUNC) &_GUTS_guts_lpx_engine, 6},
+    {"_GUTS_guts_constant_exposure_engine", (DL_FUNC) &_GUTS_guts_constant_exposure_engine, 6},
+    {"_GUTS_guts_lcx_engine", (DL_FUNC) &_GUTS_guts_lcx_engine, 7},
+    {"_GUTS_guts_window_scan_engine", (DL_FUNC) &_GUTS_guts_window_scan_engine, 10},
+    {"_GUTS_guts_exposure_batch_engine", (DL_FUNC) &_GUTS_guts_exposure_batch_engine, 10},
+    {"_GUTS_guts_survival_batch_engine", (DL_FUNC) &_GUTS_guts_survival_batch_engine, 5},
+    {"_GUTS_guts_mcmc_engine", (DL_FUNC) &_GUTS_guts_mcmc_engine, 14},
+    {"_GUTS_guts_ensemble_engine", (DL_FUNC) &_GUTS_guts_ensemble_engine, 10},
+    {"_GUTS_guts_fit_engine", (DL_FUNC) &_GUTS_guts_fit_engine, 11},
+    {"_GUTS_guts_fit_global_engine", (DL_FUNC) &_GUTS_guts_fit_global_engine, 12},
+    {"_GUTS_guts_gradient_engine", (DL_FUNC) &_GUTS_guts_gradient_engine, 3},
+    {"_GUTS_guts_profile_engine", (DL_FUNC) &_GUTS_guts_profile_engine, 15},
+    {"_GUTS_guts_simulate_engine", (DL_FUNC) &_GUTS_guts_simulate_engine, 7},
+    {"_GUTS_guts_predictive_bands_engine", (DL_FUNC) &_GUTS_guts_predictive_bands_engine, 6},
     {NULL, NULL, 0}
 };
 
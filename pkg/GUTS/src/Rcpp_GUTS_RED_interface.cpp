@@ -8,14 +8,18 @@
  * updated: 2021-11-30 
  * updated: 2022-01-17
  * updated: 2022-02-01
+ * updated: 2026-10-19
  */
 
 #include <Rcpp.h>
 #include <cctype>
 #include <iterator>
 #include <vector>
-#include "GUTS_RED.h"
-#include "external_data.h"
+#include <GUTS/GUTS_RED.h>
+#include <GUTS/external_data.h>
+#include "guts_cache.h"
+#include "guts_native.h"
+#include <GUTS/guts_instrument.h>
 
 typedef Rcpp::NumericVector ttime;
 typedef Rcpp::NumericVector tconc;
@@ -25,23 +29,30 @@ typedef Rcpp::IntegerVector tobssurv;
 typedef R_xlen_t vec_size_t; 
 
 
-enum TD_type {
-  PROPER = 0,
-  IT = 1,
-  SD = 2
-};
-
-// RCPP_EXPOSED_ENUM_NODECL(TD_type)
+// enums TD_type and dist_type are defined in guts_native.h
 
-enum dist_type {
-  LOGLOGISTIC = 0,
-  LOGNORMAL = 1,
-  DELTA = 2,
-  EXTERNAL = 3
+/**
+ * \brief Options of a single call to guts_engine
+ * \details
+ *   - stop_on_failure: throw numerical failures as R errors (otherwise LL = -Inf)
+ *   - log_survival: track survival in log-space (GUTS attribute "log_survival")
+ *   - single_precision: store threshold bins of external proper models in single precision
+ *     (GUTS attribute "single_precision", see proper_precision)
+ *   - quadrature: place thresholds of lognormal and loglogistic proper models at Gauss
+ *     quadrature nodes (GUTS attribute "quadrature", see quad_lognormal and quad_loglogistic)
+ *   - trapezoid: integrate the hazard of SD and proper models with the trapezoidal rule
+ *     (GUTS attribute "trapezoid", see guts_projector_base::set_trapezoid)
+ *   - LL_lower_bound: stop the projection once the loglikelihood cannot exceed this bound
+ */
+struct engine_options {
+  bool stop_on_failure;
+  bool log_survival;
+  bool single_precision;
+  bool quadrature;
+  bool trapezoid;
+  double LL_lower_bound;
 };
 
-// RCPP_EXPOSED_ENUM_NODECL(Dist_type)
-
 template<typename TD_mod >
 struct Rcpp_fast_projector : 
     public guts_projector_fastIT<guts_RED<ttime, tconc, TD_mod, tpara >, ttime, tsurv > {
@@ -53,9 +64,21 @@ struct Rcpp_fast_projector :
             const external_data<ttime, tconc, false, add_distribution_sample_size >& data) {
         this->initialize(data);
     }
-    Rcpp::NumericVector predict(const tpara& parameters) {
-        tsurv survival_probabilities = project(*this, parameters);
-        return  Rcpp::wrap(survival_probabilities);
+    guts_status try_predict(const tpara& parameters) {
+        return try_project(*this, parameters);
+    }
+    guts_status try_predict(const tpara& parameters, const tobssurv& y, const double lower_bound, double& LL, bool& rejected) {
+        return try_project_loglikelihood(*this, parameters, y, lower_bound, LL, rejected);
+    }
+    tsurv get_S() const {
+        tsurv survival_probabilities;
+        this -> get_survival_projection(survival_probabilities);
+        return survival_probabilities;
+    }
+    tsurv get_log_S() const {
+        tsurv log_survival_probabilities;
+        this -> get_log_survival_projection(log_survival_probabilities);
+        return log_survival_probabilities;
     }
     std::vector<double > get_D() const {
     	return this -> get_damage();
@@ -76,9 +99,21 @@ struct Rcpp_projector :
             const external_data<ttime, tconc, true, add_distribution_sample_size >& data) {
         this->initialize(data);
     }
-    Rcpp::NumericVector predict(const tpara& parameters) {
-        tsurv survival_probabilities = project(*this, parameters);
-        return  Rcpp::wrap(survival_probabilities);
+    guts_status try_predict(const tpara& parameters) {
+        return try_project(*this, parameters);
+    }
+    guts_status try_predict(const tpara& parameters, const tobssurv& y, const double lower_bound, double& LL, bool& rejected) {
+        return try_project_loglikelihood(*this, parameters, y, lower_bound, LL, rejected);
+    }
+    tsurv get_S() const {
+        tsurv survival_probabilities;
+        this -> get_survival_projection(survival_probabilities);
+        return survival_probabilities;
+    }
+    tsurv get_log_S() const {
+        tsurv log_survival_probabilities;
+        this -> get_log_survival_projection(log_survival_probabilities);
+        return log_survival_probabilities;
     }
     std::vector<double > get_D() const {
       return this -> get_damage();
@@ -115,19 +150,61 @@ Rcpp::NumericVector combine_par_and_external_distribution(
   return all_values;
 }
 
-template<typename tProjector, typename tData, typename tPara >
-void project_to_gobj(Rcpp::List gobj, tProjector& proj, const tData& dat, const tPara& par) {
-  proj.add_data(dat);
-  gobj["S"] = proj.predict(par);
-  gobj["D"] = proj.get_D();
-  gobj["Dt"] = proj.get_Dt();
+// Reason code of a projection as named integer (name: label of the code)
+Rcpp::IntegerVector wrap_status(const guts_status status) {
+  Rcpp::IntegerVector code = Rcpp::IntegerVector::create(static_cast<int >(status));
+  code.names() = Rcpp::CharacterVector::create(status_label(status));
+  return code;
 }
 
-// [[Rcpp::export]]
-void guts_engine( Rcpp::List gobj, Rcpp::NumericVector par, Rcpp::Nullable<Rcpp::NumericVector > z_dist = R_NilValue) {
-  if (!gobj.inherits("GUTS")) {
-    Rcpp::stop( "No GUTS object. Use `guts_setup()` to create or modify objects." );
+template<typename tProjector, typename tData, typename tPara >
+guts_status project_to_gobj(Rcpp::List gobj, tProjector& proj, const tData& dat, const tPara& par, const engine_options& opt) {
+  {
+    GUTS_INSTRUMENT_SCOPE(setup);
+    proj.add_data(dat);
+  }
+  proj.set_log_survival(opt.log_survival);
+  proj.set_trapezoid(opt.trapezoid);
+  tobssurv y = gobj["y"];
+  double LL = R_NegInf;
+  bool rejected = false;
+  guts_status status = opt.LL_lower_bound > R_NegInf ? 
+    proj.try_predict(par, y, opt.LL_lower_bound, LL, rejected) :
+    proj.try_predict(par);
+  if (status == guts_status::ok && rejected) status = guts_status::rejected_early;
+  gobj["status"] = wrap_status(status);
+  if (status != guts_status::ok) {
+    if (opt.stop_on_failure) throw_on_status(status);
+    Rcpp::NumericVector yt = gobj["yt"];
+    gobj["S"] = Rcpp::NumericVector(yt.size(), NA_REAL);
+    gobj["D"] = NA_REAL;
+    gobj["Dt"] = NA_REAL;
+    // upper bound of the loglikelihood if rejected early
+    gobj["LL"] = LL;
+    return status;
   }
+  tsurv S = proj.get_S();
+  {
+    GUTS_INSTRUMENT_SCOPE(reporting);
+    gobj["S"] = S;
+    gobj["D"] = proj.get_D();
+    gobj["Dt"] = proj.get_Dt();
+  }
+  if (opt.LL_lower_bound > R_NegInf) {
+    gobj["LL"] = LL;
+  } else {
+    GUTS_INSTRUMENT_SCOPE(loglikelihood);
+    gobj["LL"] = opt.log_survival ? 
+      calculate_loglikelihood_from_log_survival<tsurv, tobssurv >(proj.get_log_S(), y) :
+      calculate_loglikelihood<tsurv, tobssurv >(S, y);
+  }
+  return status;
+}
+
+// Projects the parameters with the projector of the model and distribution of gobj
+// and writes the fields S, D, Dt, LL and status.
+guts_status project_gobj(Rcpp::List gobj, Rcpp::NumericVector par, Rcpp::Nullable<Rcpp::NumericVector > z_dist, const engine_options& opt) {
+  guts_status status = guts_status::ok;
   tpara par_obj = gobj["par"];
   vec_size_t par_len = par_obj.length();
   //unsigned par_len = static_cast<unsigned >(gobj.attr("par_len"));
@@ -139,20 +216,21 @@ void guts_engine( Rcpp::List gobj, Rcpp::NumericVector par, Rcpp::Nullable<Rcpp:
     case dist_type::LOGLOGISTIC : {
       if (par.size() != par_len) Rcpp::stop("IT-loglogistic: Need parameters hb, kd, mn and beta"); 
       Rcpp_fast_projector<TD_IT_loglogistic > proj;
-      project_to_gobj(gobj, proj, dat, Rcpp::NumericVector::create(par[0], par[1], NA_REAL, par[2], par[3]));
+      status = project_to_gobj(gobj, proj, dat, Rcpp::NumericVector::create(par[0], par[1], NA_REAL, par[2], par[3]), opt);
       break;
     }
     case dist_type::LOGNORMAL : {
       if (par.size() != par_len) Rcpp::stop("IT-lognormal: Need parameters hb, kd, mn and sd"); 
       Rcpp_fast_projector<TD_IT_lognormal > proj;
-      project_to_gobj(gobj, proj, dat, Rcpp::NumericVector::create(par[0], par[1], NA_REAL, par[2], par[3]));
+      status = project_to_gobj(gobj, proj, dat, Rcpp::NumericVector::create(par[0], par[1], NA_REAL, par[2], par[3]), opt);
       break;
     }
     case dist_type::EXTERNAL : {
       if (par.size() != par_len) Rcpp::stop("IT-external: Need parameters hb and kd"); 
       Rcpp_fast_projector<TD<random_sample<tpara > , 'I' > > proj;
-      project_to_gobj(gobj, proj, dat, 
-                      combine_par_and_external_distribution(par, z_dist)
+      status = project_to_gobj(gobj, proj, dat, 
+                      combine_par_and_external_distribution(par, z_dist),
+                      opt
       );
       break;
     }
@@ -167,7 +245,7 @@ void guts_engine( Rcpp::List gobj, Rcpp::NumericVector par, Rcpp::Nullable<Rcpp:
     ext_dat_timediscrete dat;
     dat.set_data_unchecked(gobj["Ct"], gobj["C"], gobj["yt"], gobj["M"], gobj["SVR"]);
     Rcpp_projector<TD_SD > proj;
-    project_to_gobj(gobj, proj, dat, par);
+    status = project_to_gobj(gobj, proj, dat, par, opt);
     break;
   }
   case TD_type::PROPER : {
@@ -176,16 +254,26 @@ void guts_engine( Rcpp::List gobj, Rcpp::NumericVector par, Rcpp::Nullable<Rcpp:
       if (par.size() != par_len) Rcpp::stop("Proper-loglogistic: Need parameters hb, kd, kk, mn and beta"); 
       ext_dat_timediscrete_thresholddistdiscrete dat;
       dat.set_data_unchecked(gobj["Ct"], gobj["C"], gobj["yt"], gobj["M"], gobj["N"], gobj["SVR"]);
+      if (opt.quadrature) {
+        Rcpp_projector<TD_proper_quad_loglogistic > proj;
+        status = project_to_gobj(gobj, proj, dat, par, opt);
+        break;
+      }
       Rcpp_projector<TD_proper_loglogistic > proj;
-      project_to_gobj(gobj, proj, dat, par);
+      status = project_to_gobj(gobj, proj, dat, par, opt);
       break;
     } 
     case dist_type::LOGNORMAL : {
       if (par.size() != par_len) Rcpp::stop("Proper-lognormal: Need parameters hb, kd, kk, mn and sd"); 
       ext_dat_timediscrete_thresholddistdiscrete dat;
       dat.set_data_unchecked(gobj["Ct"], gobj["C"], gobj["yt"], gobj["M"], gobj["N"], gobj["SVR"]);
+      if (opt.quadrature) {
+        Rcpp_projector<TD_proper_quad_lognormal > proj;
+        status = project_to_gobj(gobj, proj, dat, par, opt);
+        break;
+      }
       Rcpp_projector<TD_proper_lognormal > proj;
-      project_to_gobj(gobj, proj, dat, par);
+      status = project_to_gobj(gobj, proj, dat, par, opt);
       break;
     }
     case dist_type::DELTA : {
@@ -193,16 +281,23 @@ void guts_engine( Rcpp::List gobj, Rcpp::NumericVector par, Rcpp::Nullable<Rcpp:
       ext_dat_timediscrete dat;
       dat.set_data_unchecked(gobj["Ct"], gobj["C"], gobj["yt"], gobj["M"], gobj["SVR"]);
       Rcpp_projector<TD_proper_delta > proj;
-      project_to_gobj(gobj, proj, dat, par);
+      status = project_to_gobj(gobj, proj, dat, par, opt);
       break;
     } 
     case dist_type::EXTERNAL : {
       if (par.size() != par_len) Rcpp::stop("Proper-external: Need parameters hb, kd and kk"); 
       ext_dat_timediscrete dat;
       dat.set_data_unchecked(gobj["Ct"], gobj["C"], gobj["yt"], gobj["M"], gobj["SVR"]);
+      if (opt.single_precision) {
+        Rcpp_projector<TD<random_sample<std::vector<float > >, 'P' > > proj;
+        status = project_to_gobj(
+          gobj, proj, dat, combine_par_and_external_distribution(par, z_dist), opt
+        );
+        break;
+      }
       Rcpp_projector<TD<random_sample<tpara >, 'P' > > proj;
-      project_to_gobj(
-        gobj, proj, dat, combine_par_and_external_distribution(par, z_dist)
+      status = project_to_gobj(
+        gobj, proj, dat, combine_par_and_external_distribution(par, z_dist), opt
       );
       break;
     }
@@ -216,10 +311,131 @@ void guts_engine( Rcpp::List gobj, Rcpp::NumericVector par, Rcpp::Nullable<Rcpp:
     Rcpp::stop("model needs to be one of 'Proper', 'IT' or 'SD'");
     break;
   }
+  return status;
+}
+
+// The cache of a GUTS object (attribute "cache"), or nullptr.
+// The pointer is also null if the object was saved and loaded again.
+likelihood_cache* get_likelihood_cache(const Rcpp::List& gobj) {
+  if (!gobj.hasAttribute("cache")) return nullptr;
+  SEXP cache = gobj.attr("cache");
+  if (TYPEOF(cache) != EXTPTRSXP) return nullptr;
+  return Rcpp::XPtr<likelihood_cache >(cache).get();
+}
+
+// As project_gobj, but returns the stored result for parameters of a previous call.
+// Projections stopped early are not stored, hits are exact results even if LL_lower_bound is set.
+void project_gobj_cached(Rcpp::List gobj, Rcpp::NumericVector par, Rcpp::Nullable<Rcpp::NumericVector > z_dist, const engine_options& opt, likelihood_cache& cache) {
+  if (z_dist.isNull()) {
+    cache.set_context(nullptr, 0);
+  } else {
+    Rcpp::NumericVector zd(z_dist.get());
+    cache.set_context(zd.begin(), static_cast<std::size_t >(zd.size()));
+  }
+  const std::string key = likelihood_cache::key_of(par.begin(), static_cast<std::size_t >(par.size()));
+  const cached_projection* hit = cache.find(key);
+  if (hit != nullptr) {
+    if (opt.stop_on_failure) throw_on_status(hit->status);
+    gobj["status"] = wrap_status(hit->status);
+    gobj["S"] = hit->S;
+    gobj["D"] = hit->D;
+    gobj["Dt"] = hit->Dt;
+    gobj["LL"] = hit->LL;
+    return;
+  }
+  const guts_status status = project_gobj(gobj, par, z_dist, opt);
+  if (status == guts_status::rejected_early) return;
+  cached_projection entry;
+  entry.S = Rcpp::as<std::vector<double > >(gobj["S"]);
+  entry.D = Rcpp::as<std::vector<double > >(gobj["D"]);
+  entry.Dt = Rcpp::as<std::vector<double > >(gobj["Dt"]);
+  entry.LL = Rcpp::as<double >(gobj["LL"]);
+  entry.status = status;
+  cache.insert(key, std::move(entry));
+}
+
+// [[Rcpp::export]]
+void guts_engine( Rcpp::List gobj, Rcpp::NumericVector par, Rcpp::Nullable<Rcpp::NumericVector > z_dist = R_NilValue, bool stop_on_failure = true, double LL_lower_bound = R_NegInf) {
+  if (!gobj.inherits("GUTS")) {
+    Rcpp::stop( "No GUTS object. Use `guts_setup()` to create or modify objects." );
+  }
+  engine_options opt;
+  opt.stop_on_failure = stop_on_failure;
+  opt.log_survival = gobj.hasAttribute("log_survival") && Rcpp::as<bool >(gobj.attr("log_survival"));
+  opt.single_precision = gobj.hasAttribute("single_precision") && Rcpp::as<bool >(gobj.attr("single_precision"));
+  opt.quadrature = gobj.hasAttribute("quadrature") && Rcpp::as<bool >(gobj.attr("quadrature"));
+  opt.trapezoid = gobj.hasAttribute("trapezoid") && Rcpp::as<bool >(gobj.attr("trapezoid"));
+  opt.LL_lower_bound = std::isnan(LL_lower_bound) ? R_NegInf : LL_lower_bound;
+  likelihood_cache* cache = get_likelihood_cache(gobj);
+  if (cache == nullptr) {
+    project_gobj(gobj, par, z_dist, opt);
+  } else {
+    project_gobj_cached(gobj, par, z_dist, opt, *cache);
+  }
 
   gobj["par"] = par;
   gobj["external_dist"] = z_dist;
-  gobj["LL"] = calculate_loglikelihood<tsurv, tobssurv >(gobj["S"], gobj["y"]);
   gobj["SPPE"] = calculate_SPPE<tsurv, tobssurv >(gobj["S"], gobj["y"]);
   gobj["squares"] = calculate_sum_of_squares<tsurv, tobssurv >(gobj["S"], gobj["y"]);
-}
\ No newline at end of file
+}
+
+// Creates the projection cache of a GUTS object
+//
+// @param cache_size maximum number of stored projections
+//
+// @return external pointer to the cache
+// [[Rcpp::export]]
+SEXP guts_cache_create(int cache_size) {
+  if (cache_size < 1) Rcpp::stop("cache_size must be a positive integer.");
+  return Rcpp::XPtr<likelihood_cache >(new likelihood_cache(static_cast<std::size_t >(cache_size)), true);
+}
+
+// Statistics of the projection cache of a GUTS object
+//
+// @param gobj GUTS object
+//
+// @return named vector: capacity, size (stored projections), hits, misses and evictions; zeros without cache
+// [[Rcpp::export]]
+Rcpp::NumericVector guts_cache_report(Rcpp::List gobj) {
+  const likelihood_cache* cache = get_likelihood_cache(gobj);
+  Rcpp::NumericVector ret = Rcpp::NumericVector::create(
+    Rcpp::Named("capacity") = cache ? static_cast<double >(cache->get_capacity()) : 0.0,
+    Rcpp::Named("size") = cache ? static_cast<double >(cache->get_size()) : 0.0,
+    Rcpp::Named("hits") = cache ? static_cast<double >(cache->get_hits()) : 0.0,
+    Rcpp::Named("misses") = cache ? static_cast<double >(cache->get_misses()) : 0.0,
+    Rcpp::Named("evictions") = cache ? static_cast<double >(cache->get_evictions()) : 0.0
+  );
+  return ret;
+}
+
+// Profile of all evaluations since the last reset (see guts_instrument.h)
+//
+// @return list: enabled (compiled with GUTS_INSTRUMENT), counts (named vector of the counted
+//   events) and phases (named vectors calls and seconds of the timed phases); zeros if not enabled
+// [[Rcpp::export]]
+Rcpp::List guts_instrument_report() {
+  const guts_instrument_totals totals = guts_instrument_collect();
+  Rcpp::NumericVector counts(totals.counts.begin(), totals.counts.end());
+  counts.names() = Rcpp::CharacterVector::create(
+    "calculate_damage", "gather_effect", "survival", "bin_walk", "time_steps", "allocations"
+  );
+  const Rcpp::CharacterVector phase_names = Rcpp::CharacterVector::create(
+    "setup", "sample", "projection", "survival", "loglikelihood", "reporting"
+  );
+  Rcpp::NumericVector calls(totals.calls.begin(), totals.calls.end());
+  calls.names() = phase_names;
+  Rcpp::NumericVector seconds(totals.seconds.begin(), totals.seconds.end());
+  seconds.names() = phase_names;
+  return Rcpp::List::create(
+    Rcpp::Named("enabled") = guts_instrument_enabled(),
+    Rcpp::Named("counts") = counts,
+    Rcpp::Named("calls") = calls,
+    Rcpp::Named("seconds") = seconds
+  );
+}
+
+// Set the profile to zero
+// [[Rcpp::export]]
+void guts_instrument_clear() {
+  guts_instrument_reset();
+}
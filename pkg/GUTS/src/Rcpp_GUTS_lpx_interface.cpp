@@ -0,0 +1,264 @@
+/**
+ * GUTS: Fast Calculation of the Likelihood of a Stochastic Survival Model.
+ * Functions guts_lpx_engine, guts_constant_exposure_engine, guts_lcx_engine, guts_window_scan_engine, guts_exposure_batch_engine, guts_survival_batch_engine
+ * soeren.vogel@posteo.ch, carlo.albert@eawag.ch, alexander singer@rifcon.de, oliver.jakoby@rifcon.de, dirk.nickisch@rifcon.de
+ * License GPL-2
+ * 2026-10-19
+ */
+
+#include <Rcpp.h>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Rcpp_GUTS_native.h"
+#include "guts_lpx.h"
+
+// Multiplication factors of the exposure profile of a GUTS object
+//
+// @param gobj GUTS object
+// @param par matrix of parameters, one set per row
+// @param effects effects in (0, 1)
+// @param tol relative tolerance of the factors
+// @param n_threads number of threads
+// @param z_dist sample of thresholds (dist = 'external' only)
+//
+// @return matrix of multiplication factors, one column per effect
+// [[Rcpp::export]]
+Rcpp::NumericMatrix guts_lpx_engine(
+    Rcpp::List gobj,
+    Rcpp::NumericMatrix par,
+    Rcpp::NumericVector effects,
+    double tol,
+    int n_threads,
+    Rcpp::Nullable<Rcpp::NumericVector > z_dist = R_NilValue
+) {
+  const guts_native_data data = as_guts_native_data(gobj, z_dist);
+  const std::vector<double > mf = run_lpx(
+    data,
+    std::vector<double >(par.begin(), par.end()),
+    par.nrow(),
+    Rcpp::as<std::vector<double > >(effects),
+    tol,
+    n_threads
+  );
+  return Rcpp::NumericMatrix(par.nrow(), effects.size(), mf.begin());
+}
+
+// Survival of a GUTS model under constant exposure
+//
+// @param gobj GUTS object (model, distribution and settings)
+// @param par matrix of parameters, one set per row
+// @param conc constant concentrations
+// @param t times
+// @param n_threads number of threads
+// @param z_dist sample of thresholds (dist = 'external' only)
+//
+// @return array of survival probabilities (parameter set x concentration x time)
+// [[Rcpp::export]]
+Rcpp::NumericVector guts_constant_exposure_engine(
+    Rcpp::List gobj,
+    Rcpp::NumericMatrix par,
+    Rcpp::NumericVector conc,
+    Rcpp::NumericVector t,
+    int n_threads,
+    Rcpp::Nullable<Rcpp::NumericVector > z_dist = R_NilValue
+) {
+  const guts_native_data data = as_guts_native_data(gobj, z_dist);
+  Rcpp::NumericVector ret = Rcpp::wrap(run_constant_exposure_survival(
+    data,
+    std::vector<double >(par.begin(), par.end()),
+    par.nrow(),
+    Rcpp::as<std::vector<double > >(conc),
+    Rcpp::as<std::vector<double > >(t),
+    n_threads
+  ));
+  ret.attr("dim") = Rcpp::IntegerVector::create(par.nrow(), conc.size(), t.size());
+  return ret;
+}
+
+// Lethal concentrations of constant exposure
+//
+// @param gobj GUTS object (model, distribution and settings)
+// @param par matrix of parameters, one set per row
+// @param effects effects in (0, 1)
+// @param t times
+// @param tol relative tolerance of the concentrations
+// @param n_threads number of threads
+// @param z_dist sample of thresholds (dist = 'external' only)
+//
+// @return array of concentrations (parameter set x time x effect)
+// [[Rcpp::export]]
+Rcpp::NumericVector guts_lcx_engine(
+    Rcpp::List gobj,
+    Rcpp::NumericMatrix par,
+    Rcpp::NumericVector effects,
+    Rcpp::NumericVector t,
+    double tol,
+    int n_threads,
+    Rcpp::Nullable<Rcpp::NumericVector > z_dist = R_NilValue
+) {
+  const guts_native_data data = as_guts_native_data(gobj, z_dist);
+  Rcpp::NumericVector ret = Rcpp::wrap(run_lcx(
+    data,
+    std::vector<double >(par.begin(), par.end()),
+    par.nrow(),
+    Rcpp::as<std::vector<double > >(effects),
+    Rcpp::as<std::vector<double > >(t),
+    tol,
+    n_threads
+  ));
+  ret.attr("dim") = Rcpp::IntegerVector::create(par.nrow(), t.size(), effects.size());
+  return ret;
+}
+
+// Survival and multiplication factors of windows of an exposure profile
+//
+// @param gobj GUTS object (model, distribution and settings; M time steps per window)
+// @param par parameters
+// @param Ct,C exposure profile
+// @param window length of windows
+// @param starts window starts
+// @param effects effects in (0, 1)
+// @param tol relative tolerance of the factors
+// @param n_threads number of threads
+// @param z_dist sample of thresholds (dist = 'external' only)
+//
+// @return list with window starts, relative survival and the matrix of multiplication factors
+// [[Rcpp::export]]
+Rcpp::List guts_window_scan_engine(
+    Rcpp::List gobj,
+    Rcpp::NumericVector par,
+    Rcpp::NumericVector Ct,
+    Rcpp::NumericVector C,
+    double window,
+    Rcpp::NumericVector starts,
+    Rcpp::NumericVector effects,
+    double tol,
+    int n_threads,
+    Rcpp::Nullable<Rcpp::NumericVector > z_dist = R_NilValue
+) {
+  guts_native_data data = as_guts_native_data(gobj, z_dist);
+  data.Ct = Rcpp::as<std::vector<double > >(Ct);
+  data.C = Rcpp::as<std::vector<double > >(C);
+  const window_scan_result scan = run_window_scan(
+    data,
+    Rcpp::as<std::vector<double > >(par),
+    window,
+    Rcpp::as<std::vector<double > >(starts),
+    Rcpp::as<std::vector<double > >(effects),
+    tol,
+    n_threads
+  );
+  return Rcpp::List::create(
+    Rcpp::Named("start") = scan.start,
+    Rcpp::Named("survival") = scan.survival,
+    Rcpp::Named("mf") = Rcpp::NumericMatrix(starts.size(), effects.size(), scan.mf.begin())
+  );
+}
+
+// Survival and multiplication factors of exposure profiles for parameter samples
+//
+// @param gobj GUTS object (model, distribution and settings)
+// @param par matrix of parameters, one set per row
+// @param Ct list of exposure times of the profiles, each starting at 0
+// @param C list of concentrations of the profiles
+// @param dtau time step of the discretization
+// @param effects effects in (0, 1)
+// @param tol relative tolerance of the factors
+// @param n_threads number of threads
+// @param file result file ("": none)
+// @param z_dist sample of thresholds (dist = 'external' only)
+//
+// @return list with survival (profile x parameter set) and mf (profile x parameter set x effect);
+//   NULL if written to file
+// [[Rcpp::export]]
+SEXP guts_exposure_batch_engine(
+    Rcpp::List gobj,
+    Rcpp::NumericMatrix par,
+    Rcpp::List Ct,
+    Rcpp::List C,
+    double dtau,
+    Rcpp::NumericVector effects,
+    double tol,
+    int n_threads,
+    std::string file = "",
+    Rcpp::Nullable<Rcpp::NumericVector > z_dist = R_NilValue
+) {
+  const guts_native_data data = as_guts_native_data(gobj, z_dist);
+  std::vector<guts_native_data > profiles(Ct.size(), data);
+  for (R_xlen_t p = 0; p < Ct.size(); ++p) {
+    profiles[p].Ct = Rcpp::as<std::vector<double > >(Ct[p]);
+    profiles[p].C = Rcpp::as<std::vector<double > >(C[p]);
+    profiles[p].yt.assign(1, 0.0);
+    profiles[p].yt.push_back(profiles[p].Ct.back());
+    profiles[p].M = std::max<std::size_t >(1, std::ceil(profiles[p].Ct.back() / dtau));
+  }
+  if (!file.empty()) {
+    std::vector<std::string > names = {"profile", "sample", "survival"};
+    std::vector<column_type > types = {column_type::int32, column_type::int32, column_type::float64};
+    for (R_xlen_t e = 0; e < effects.size(); ++e) {
+      std::ostringstream name;
+      name << "LP" << 100.0 * effects[e];
+      names.push_back(name.str());
+      types.push_back(column_type::float64);
+    }
+    guts_result_sink sink(file, names, types, static_cast<std::uint64_t >(Ct.size()) * par.nrow());
+    run_exposure_batch(
+      profiles,
+      std::vector<double >(par.begin(), par.end()),
+      par.nrow(),
+      Rcpp::as<std::vector<double > >(effects),
+      tol,
+      n_threads,
+      &sink
+    );
+    sink.finish();
+    return R_NilValue;
+  }
+  const exposure_batch_result batch = run_exposure_batch(
+    profiles,
+    std::vector<double >(par.begin(), par.end()),
+    par.nrow(),
+    Rcpp::as<std::vector<double > >(effects),
+    tol,
+    n_threads
+  );
+  Rcpp::NumericVector mf = Rcpp::wrap(batch.mf);
+  mf.attr("dim") = Rcpp::IntegerVector::create(Ct.size(), par.nrow(), effects.size());
+  return Rcpp::List::create(
+    Rcpp::Named("survival") = Rcpp::NumericMatrix(Ct.size(), par.nrow(), batch.survival.begin()),
+    Rcpp::Named("mf") = mf
+  );
+}
+
+// Survival of GUTS objects for parameter samples, written to a result file
+//
+// @param gobjs list of GUTS objects with the same model and distribution
+// @param par matrix of parameters, one set per row
+// @param file result file
+// @param n_threads number of threads
+// @param z_dist sample of thresholds (dist = 'external' only)
+//
+// @return number of rows of the result file
+// [[Rcpp::export]]
+double guts_survival_batch_engine(
+    Rcpp::List gobjs,
+    Rcpp::NumericMatrix par,
+    std::string file,
+    int n_threads,
+    Rcpp::Nullable<Rcpp::NumericVector > z_dist = R_NilValue
+) {
+  const std::vector<guts_native_data > data = as_guts_native_data_list(gobjs, z_dist);
+  std::uint64_t n_rows = 0;
+  for (const guts_native_data& d : data) n_rows += static_cast<std::uint64_t >(par.nrow()) * d.yt.size();
+  guts_result_sink sink(
+    file,
+    {"profile", "sample", "time", "survival"},
+    {column_type::int32, column_type::int32, column_type::float64, column_type::float64},
+    n_rows
+  );
+  run_survival_batch(data, std::vector<double >(par.begin(), par.end()), par.nrow(), sink, n_threads);
+  sink.finish();
+  return static_cast<double >(n_rows);
+}
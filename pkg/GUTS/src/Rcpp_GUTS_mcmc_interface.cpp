@@ -0,0 +1,148 @@
+/**
+ * GUTS: Fast Calculation of the Likelihood of a Stochastic Survival Model.
+ * Function guts_mcmc_engine
+ * soeren.vogel@posteo.ch, carlo.albert@eawag.ch, alexander singer@rifcon.de, oliver.jakoby@rifcon.de, dirk.nickisch@rifcon.de
+ * License GPL-2
+ * 2026-10-19
+ */
+
+#include <Rcpp.h>
+#include <vector>
+#include "Rcpp_GUTS_native.h"
+#include "guts_mcmc.h"
+
+// Chain as list with fields of adaptMCMC::MCMC
+Rcpp::List wrap_chain(const mcmc_chain& chain) {
+  Rcpp::NumericMatrix samples(chain.n, chain.d, chain.samples.begin());
+  Rcpp::NumericMatrix cov_jump(chain.d, chain.d, chain.cov_jump.begin());
+  return Rcpp::List::create(
+    Rcpp::Named("samples") = samples,
+    Rcpp::Named("log.p") = Rcpp::wrap(chain.log_p),
+    Rcpp::Named("cov.jump") = cov_jump,
+    Rcpp::Named("acceptance.rate") = static_cast<double >(chain.accepted) / static_cast<double >(chain.n),
+    Rcpp::Named("rejected.early") = static_cast<double >(chain.rejected_early),
+    Rcpp::Named("screened") = static_cast<double >(chain.screened)
+  );
+}
+
+// Robust adaptive Metropolis sampler on the joint loglikelihood of GUTS objects
+//
+// @param gobjs list of GUTS objects with common parameters
+// @param init initial parameters, one row per chain
+// @param scale initial proposal covariance
+// @param lower,upper parameter bounds (uniform prior)
+// @param n,adapt,acc_rate,gamma see guts_mcmc
+// @param early_rejection stop projections below the acceptance threshold after adaptation
+// @param seed seed of the random number streams of the chains
+// @param n_threads number of threads
+// @param z_dist sample of thresholds (dist = 'external' only)
+// @param coarse_factor divisor of M and N of the surrogate for delayed acceptance (NA: none)
+//
+// @return list of chains
+// [[Rcpp::export]]
+Rcpp::List guts_mcmc_engine(
+    Rcpp::List gobjs,
+    Rcpp::NumericMatrix init,
+    Rcpp::NumericMatrix scale,
+    Rcpp::NumericVector lower,
+    Rcpp::NumericVector upper,
+    int n,
+    int adapt,
+    double acc_rate,
+    double gamma,
+    bool early_rejection,
+    double seed,
+    int n_threads,
+    Rcpp::Nullable<Rcpp::NumericVector > z_dist = R_NilValue,
+    double coarse_factor = NA_REAL
+) {
+  const std::vector<guts_native_data > data = as_guts_native_data_list(gobjs, z_dist);
+  std::vector<guts_native_data > coarse_data;
+  if (!std::isnan(coarse_factor)) coarse_data = coarsen_discretization(data, coarse_factor);
+
+  std::vector<std::vector<double > > inits(init.nrow());
+  for (int c = 0; c < init.nrow(); ++c) {
+    Rcpp::NumericVector row = init(c, Rcpp::_);
+    inits[c].assign(row.begin(), row.end());
+  }
+  parameter_bounds bounds;
+  bounds.lower.assign(lower.begin(), lower.end());
+  bounds.upper.assign(upper.begin(), upper.end());
+  adaptive_metropolis_settings settings;
+  settings.n = n;
+  settings.adapt = adapt;
+  settings.acc_rate = acc_rate;
+  settings.gamma = gamma;
+  settings.early_rejection = early_rejection;
+
+  const std::vector<mcmc_chain > chains = run_adaptive_metropolis_chains(
+    data, bounds, inits, Rcpp::as<std::vector<double > >(scale), settings,
+    static_cast<std::uint32_t >(seed), static_cast<std::size_t >(n_threads),
+    coarse_data
+  );
+
+  Rcpp::List ret(chains.size());
+  for (std::size_t c = 0; c < chains.size(); ++c) ret[c] = wrap_chain(chains[c]);
+  return ret;
+}
+
+// Affine-invariant ensemble sampler (stretch move) on the joint loglikelihood of GUTS objects
+//
+// @param gobjs list of GUTS objects with common parameters
+// @param init initial parameters, one row per walker
+// @param lower,upper parameter bounds (uniform prior)
+// @param n number of iterations
+// @param a scale of the stretch move
+// @param early_rejection stop projections below the acceptance threshold
+// @param seed seed of the random number stream
+// @param n_threads number of threads
+// @param z_dist sample of thresholds (dist = 'external' only)
+//
+// @return list with samples (n x walkers x parameters), log.p (n x walkers) and acceptance rates
+// [[Rcpp::export]]
+Rcpp::List guts_ensemble_engine(
+    Rcpp::List gobjs,
+    Rcpp::NumericMatrix init,
+    Rcpp::NumericVector lower,
+    Rcpp::NumericVector upper,
+    int n,
+    double a,
+    bool early_rejection,
+    double seed,
+    int n_threads,
+    Rcpp::Nullable<Rcpp::NumericVector > z_dist = R_NilValue
+) {
+  const std::vector<guts_native_data > data = as_guts_native_data_list(gobjs, z_dist);
+
+  std::vector<std::vector<double > > inits(init.nrow());
+  for (int w = 0; w < init.nrow(); ++w) {
+    Rcpp::NumericVector row = init(w, Rcpp::_);
+    inits[w].assign(row.begin(), row.end());
+  }
+  parameter_bounds bounds;
+  bounds.lower.assign(lower.begin(), lower.end());
+  bounds.upper.assign(upper.begin(), upper.end());
+  ensemble_settings settings;
+  settings.n = n;
+  settings.a = a;
+  settings.early_rejection = early_rejection;
+
+  const ensemble_chain chain = run_stretch_move(
+    data, bounds, inits, settings,
+    static_cast<std::uint32_t >(seed), static_cast<std::size_t >(n_threads)
+  );
+
+  Rcpp::NumericVector samples(chain.samples.begin(), chain.samples.end());
+  samples.attr("dim") = Rcpp::IntegerVector::create(chain.n, chain.n_walkers, chain.d);
+  Rcpp::NumericMatrix log_p(chain.n, chain.n_walkers, chain.log_p.begin());
+  Rcpp::NumericVector acceptance_rate(chain.n_walkers);
+  for (std::size_t w = 0; w < chain.n_walkers; ++w) {
+    acceptance_rate[w] = static_cast<double >(chain.accepted[w]) / static_cast<double >(chain.n);
+  }
+  return Rcpp::List::create(
+    Rcpp::Named("samples") = samples,
+    Rcpp::Named("log.p") = log_p,
+    Rcpp::Named("acceptance.rate") = acceptance_rate,
+    Rcpp::Named("rejected.early") = static_cast<double >(chain.rejected_early)
+  );
+}
@@ -0,0 +1,68 @@
+/**
+ * GUTS: Fast Calculation of the Likelihood of a Stochastic Survival Model.
+ * Conversion of GUTS objects to data of native evaluators
+ * soeren.vogel@posteo.ch, carlo.albert@eawag.ch, alexander singer@rifcon.de, oliver.jakoby@rifcon.de, dirk.nickisch@rifcon.de
+ * License GPL-2
+ * 2026-10-19
+ */
+
+#ifndef RCPP_GUTS_NATIVE_H
+#define RCPP_GUTS_NATIVE_H
+
+#include <Rcpp.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "guts_native.h"
+
+// Number of time steps or sample size; 0 if not used by the model (NA)
+inline std::size_t as_discretization_size(SEXP x) {
+  const double value = Rcpp::as<double >(x);
+  return std::isfinite(value) ? static_cast<std::size_t >(value) : 0;
+}
+
+// Copies data of a GUTS object, such that it can be evaluated without the R API
+//
+// @param gobj GUTS object
+// @param z_dist unsorted sample of thresholds (dist = 'external' only)
+inline guts_native_data as_guts_native_data(Rcpp::List gobj, Rcpp::Nullable<Rcpp::NumericVector > z_dist) {
+  if (!gobj.inherits("GUTS")) {
+    Rcpp::stop( "No GUTS object. Use `guts_setup()` to create or modify objects." );
+  }
+  guts_native_data data;
+  data.C = Rcpp::as<std::vector<double > >(gobj["C"]);
+  data.Ct = Rcpp::as<std::vector<double > >(gobj["Ct"]);
+  data.yt = Rcpp::as<std::vector<double > >(gobj["yt"]);
+  data.y = Rcpp::as<std::vector<int > >(gobj["y"]);
+  data.M = as_discretization_size(gobj["M"]);
+  data.N = as_discretization_size(gobj["N"]);
+  data.SVR = Rcpp::as<double >(gobj["SVR"]);
+  data.model = static_cast<TD_type >(Rcpp::as<int >(gobj.attr("TD_type")));
+  data.dist = static_cast<dist_type >(Rcpp::as<int >(gobj.attr("dist_type")));
+  data.log_survival = gobj.hasAttribute("log_survival") && Rcpp::as<bool >(gobj.attr("log_survival"));
+  data.single_precision = gobj.hasAttribute("single_precision") && Rcpp::as<bool >(gobj.attr("single_precision"));
+  data.quadrature = gobj.hasAttribute("quadrature") && Rcpp::as<bool >(gobj.attr("quadrature"));
+  data.trapezoid = gobj.hasAttribute("trapezoid") && Rcpp::as<bool >(gobj.attr("trapezoid"));
+  if (data.dist == dist_type::EXTERNAL) {
+    if (z_dist.isNull()) Rcpp::stop("dist = external: Need threshold sample");
+    data.z_dist = Rcpp::as<std::vector<double > >(z_dist);
+    std::sort(data.z_dist.begin(), data.z_dist.end());
+  }
+  return data;
+}
+
+// Copies data of a list of GUTS objects with the same model and distribution
+inline std::vector<guts_native_data > as_guts_native_data_list(Rcpp::List gobjs, Rcpp::Nullable<Rcpp::NumericVector > z_dist) {
+  std::vector<guts_native_data > data;
+  data.reserve(gobjs.size());
+  for (R_xlen_t i = 0; i < gobjs.size(); ++i) {
+    data.push_back(as_guts_native_data(gobjs[i], z_dist));
+    if (data.back().model != data.front().model || data.back().dist != data.front().dist) {
+      Rcpp::stop("All GUTS objects need the same model and distribution.");
+    }
+  }
+  if (data.empty()) Rcpp::stop("Need at least one GUTS object.");
+  return data;
+}
+
+#endif //RCPP_GUTS_NATIVE_H
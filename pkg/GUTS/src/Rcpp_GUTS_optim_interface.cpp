@@ -0,0 +1,226 @@
+/**
+ * GUTS: Fast Calculation of the Likelihood of a Stochastic Survival Model.
+ * Functions guts_fit_engine, guts_fit_global_engine, guts_gradient_engine, guts_profile_engine
+ * soeren.vogel@posteo.ch, carlo.albert@eawag.ch, alexander singer@rifcon.de, oliver.jakoby@rifcon.de, dirk.nickisch@rifcon.de
+ * License GPL-2
+ * 2026-10-19
+ */
+
+#include <Rcpp.h>
+#include <memory>
+#include <vector>
+#include "Rcpp_GUTS_native.h"
+#include "guts_optim.h"
+
+// Maximum likelihood fit of the joint loglikelihood of GUTS objects
+//
+// @param gobjs list of GUTS objects with common parameters
+// @param init initial parameters
+// @param lower,upper parameter bounds
+// @param maxit,factr,pgtol,fd_step see guts_fit
+// @param hessian calculate the Hessian and covariance at the optimum
+// @param n_threads number of threads (finite differences)
+// @param z_dist sample of thresholds (dist = 'external' only)
+//
+// @return list with fields as optim, plus covariance and number of projections
+// [[Rcpp::export]]
+Rcpp::List guts_fit_engine(
+    Rcpp::List gobjs,
+    Rcpp::NumericVector init,
+    Rcpp::NumericVector lower,
+    Rcpp::NumericVector upper,
+    int maxit,
+    double factr,
+    double pgtol,
+    double fd_step,
+    bool hessian,
+    int n_threads,
+    Rcpp::Nullable<Rcpp::NumericVector > z_dist = R_NilValue
+) {
+  const std::vector<guts_native_data > data = as_guts_native_data_list(gobjs, z_dist);
+
+  parameter_bounds bounds;
+  bounds.lower.assign(lower.begin(), lower.end());
+  bounds.upper.assign(upper.begin(), upper.end());
+  quasi_newton_settings settings;
+  settings.max_iter = maxit;
+  settings.factr = factr;
+  settings.pgtol = pgtol;
+  settings.fd_step = fd_step;
+  settings.hessian = hessian;
+
+  const fit_result fit = run_bounded_quasi_newton(
+    data, bounds, Rcpp::as<std::vector<double > >(init), settings,
+    static_cast<std::size_t >(n_threads)
+  );
+
+  const std::size_t d = fit.par.size();
+  return Rcpp::List::create(
+    Rcpp::Named("par") = Rcpp::wrap(fit.par),
+    Rcpp::Named("value") = fit.LL,
+    Rcpp::Named("gradient") = Rcpp::wrap(fit.gradient),
+    Rcpp::Named("hessian") = Rcpp::NumericMatrix(d, d, fit.hessian.begin()),
+    Rcpp::Named("cov") = Rcpp::NumericMatrix(d, d, fit.cov.begin()),
+    Rcpp::Named("counts") = Rcpp::NumericVector::create(
+      Rcpp::Named("function") = static_cast<double >(fit.n_function),
+      Rcpp::Named("gradient") = static_cast<double >(fit.n_gradient),
+      Rcpp::Named("projection") = static_cast<double >(fit.n_projection)
+    ),
+    Rcpp::Named("iterations") = static_cast<double >(fit.iterations),
+    Rcpp::Named("convergence") = fit.convergence,
+    Rcpp::Named("message") = fit.message
+  );
+}
+
+// Differential evolution on the joint loglikelihood of GUTS objects
+//
+// @param gobjs list of GUTS objects with common parameters
+// @param init initial member of the population (NULL: none)
+// @param lower,upper finite parameter bounds
+// @param n_pop,max_gen,F,CR,reltol see guts_fit_global
+// @param seed seed of the random number stream
+// @param n_threads number of threads
+// @param z_dist sample of thresholds (dist = 'external' only)
+//
+// @return list with the best parameters, loglikelihood, final population and counts
+// [[Rcpp::export]]
+Rcpp::List guts_fit_global_engine(
+    Rcpp::List gobjs,
+    Rcpp::Nullable<Rcpp::NumericVector > init,
+    Rcpp::NumericVector lower,
+    Rcpp::NumericVector upper,
+    int n_pop,
+    int max_gen,
+    double F,
+    double CR,
+    double reltol,
+    double seed,
+    int n_threads,
+    Rcpp::Nullable<Rcpp::NumericVector > z_dist = R_NilValue
+) {
+  const std::vector<guts_native_data > data = as_guts_native_data_list(gobjs, z_dist);
+
+  parameter_bounds bounds;
+  bounds.lower.assign(lower.begin(), lower.end());
+  bounds.upper.assign(upper.begin(), upper.end());
+  std::vector<double > init_par;
+  if (init.isNotNull()) init_par = Rcpp::as<std::vector<double > >(init);
+  differential_evolution_settings settings;
+  settings.n_pop = n_pop;
+  settings.max_gen = max_gen;
+  settings.F = F;
+  settings.CR = CR;
+  settings.reltol = reltol;
+
+  const differential_evolution_result fit = run_differential_evolution(
+    data, bounds, init_par, settings,
+    static_cast<std::uint32_t >(seed), static_cast<std::size_t >(n_threads)
+  );
+
+  return Rcpp::List::create(
+    Rcpp::Named("par") = Rcpp::wrap(fit.par),
+    Rcpp::Named("value") = fit.LL,
+    Rcpp::Named("population") = Rcpp::NumericMatrix(n_pop, fit.par.size(), fit.population.begin()),
+    Rcpp::Named("population.value") = Rcpp::wrap(fit.population_LL),
+    Rcpp::Named("generations") = static_cast<double >(fit.generations),
+    Rcpp::Named("counts") = Rcpp::NumericVector::create(
+      Rcpp::Named("projection") = static_cast<double >(fit.n_projection),
+      Rcpp::Named("rejected.early") = static_cast<double >(fit.rejected_early)
+    ),
+    Rcpp::Named("convergence") = fit.convergence,
+    Rcpp::Named("message") = fit.message
+  );
+}
+
+// Joint loglikelihood of GUTS objects and its exact gradient (forward-mode automatic differentiation)
+//
+// @param gobjs list of GUTS objects with common parameters
+// @param par parameters
+// @param z_dist sample of thresholds (dist = 'external' only)
+//
+// @return loglikelihood with attribute gradient
+// [[Rcpp::export]]
+Rcpp::NumericVector guts_gradient_engine(
+    Rcpp::List gobjs,
+    Rcpp::NumericVector par,
+    Rcpp::Nullable<Rcpp::NumericVector > z_dist = R_NilValue
+) {
+  const std::vector<guts_native_data > data = as_guts_native_data_list(gobjs, z_dist);
+  std::unique_ptr<guts_evaluator > evaluator = make_guts_evaluator(data);
+  if (!evaluator->has_gradient()) {
+    Rcpp::stop("Exact gradients are not available for model IT and external threshold distributions.");
+  }
+  double LL;
+  std::vector<double > gradient;
+  evaluator->calc_loglikelihood_gradient(Rcpp::as<std::vector<double > >(par), LL, gradient);
+  Rcpp::NumericVector ret = Rcpp::NumericVector::create(LL);
+  ret.attr("gradient") = Rcpp::wrap(gradient);
+  return ret;
+}
+
+// Profile likelihoods of parameters of GUTS objects
+//
+// @param gobjs list of GUTS objects with common parameters
+// @param estimate maximum likelihood estimate
+// @param LL_max loglikelihood at estimate
+// @param which indices of the profiled parameters (from 0)
+// @param lower,upper parameter bounds
+// @param step grid step of each profiled parameter
+// @param LL_drop,max_steps see profile_settings
+// @param maxit,factr,pgtol,fd_step see guts_fit
+// @param n_threads number of threads
+// @param z_dist sample of thresholds (dist = 'external' only)
+//
+// @return list of profiles
+// [[Rcpp::export]]
+Rcpp::List guts_profile_engine(
+    Rcpp::List gobjs,
+    Rcpp::NumericVector estimate,
+    double LL_max,
+    Rcpp::IntegerVector which,
+    Rcpp::NumericVector lower,
+    Rcpp::NumericVector upper,
+    Rcpp::NumericVector step,
+    double LL_drop,
+    int max_steps,
+    int maxit,
+    double factr,
+    double pgtol,
+    double fd_step,
+    int n_threads,
+    Rcpp::Nullable<Rcpp::NumericVector > z_dist = R_NilValue
+) {
+  const std::vector<guts_native_data > data = as_guts_native_data_list(gobjs, z_dist);
+
+  parameter_bounds bounds;
+  bounds.lower.assign(lower.begin(), lower.end());
+  bounds.upper.assign(upper.begin(), upper.end());
+  profile_settings settings;
+  settings.LL_drop = LL_drop;
+  settings.max_steps = max_steps;
+  settings.fit.max_iter = maxit;
+  settings.fit.factr = factr;
+  settings.fit.pgtol = pgtol;
+  settings.fit.fd_step = fd_step;
+  settings.fit.hessian = false;
+
+  const std::vector<profile_curve > curves = run_profile_likelihood(
+    data, bounds, Rcpp::as<std::vector<double > >(estimate), LL_max,
+    Rcpp::as<std::vector<std::size_t > >(which), Rcpp::as<std::vector<double > >(step),
+    settings, static_cast<std::size_t >(n_threads)
+  );
+
+  Rcpp::List ret(curves.size());
+  for (std::size_t i = 0; i < curves.size(); ++i) {
+    const profile_curve& curve = curves[i];
+    ret[i] = Rcpp::List::create(
+      Rcpp::Named("value") = Rcpp::wrap(curve.value),
+      Rcpp::Named("LL") = Rcpp::wrap(curve.LL),
+      Rcpp::Named("par") = Rcpp::NumericMatrix(curve.value.size(), estimate.size(), curve.par.begin()),
+      Rcpp::Named("lower") = curve.lower,
+      Rcpp::Named("upper") = curve.upper,
+      Rcpp::Named("projections") = static_cast<double >(curve.n_projection)
+    );
+  }
+  return ret;
+}
@@ -0,0 +1,82 @@
+/**
+ * GUTS: Fast Calculation of the Likelihood of a Stochastic Survival Model.
+ * Functions guts_simulate_engine, guts_predictive_bands_engine
+ * soeren.vogel@posteo.ch, carlo.albert@eawag.ch, alexander singer@rifcon.de, oliver.jakoby@rifcon.de, dirk.nickisch@rifcon.de
+ * License GPL-2
+ * 2026-10-19
+ */
+
+#include <Rcpp.h>
+#include <vector>
+#include "Rcpp_GUTS_native.h"
+#include "guts_simulate.h"
+
+// Survivor counts of virtual experiments with the design of a GUTS object
+//
+// @param gobj GUTS object (design: Ct, C, yt, model, distribution and settings)
+// @param par matrix of parameters, one set per row
+// @param n_rep number of replicates per parameter set
+// @param n0 number of individuals at the first survival time
+// @param seed seed of the random number streams
+// @param n_threads number of threads
+// @param z_dist sample of thresholds (dist = 'external' only)
+//
+// @return integer matrix of survivor counts, one row per parameter set and replicate; NA for invalid parameters
+// [[Rcpp::export]]
+Rcpp::IntegerMatrix guts_simulate_engine(
+    Rcpp::List gobj,
+    Rcpp::NumericMatrix par,
+    int n_rep,
+    int n0,
+    double seed,
+    int n_threads,
+    Rcpp::Nullable<Rcpp::NumericVector > z_dist = R_NilValue
+) {
+  const guts_native_data data = as_guts_native_data(gobj, z_dist);
+  std::vector<int > y = run_survivor_simulation(
+    data,
+    std::vector<double >(par.begin(), par.end()),
+    par.nrow(),
+    n_rep,
+    n0,
+    static_cast<std::uint32_t >(seed),
+    n_threads
+  );
+  for (int& v : y) if (v < 0) v = NA_INTEGER;
+  return Rcpp::IntegerMatrix(par.nrow() * n_rep, data.yt.size(), y.begin());
+}
+
+// Posterior predictive bands of survival at the survival times of a GUTS object
+//
+// @param gobj GUTS object
+// @param par matrix of parameters, one set per row
+// @param probs probabilities of the quantiles
+// @param compression compression of the quantile sketches
+// @param n_threads number of threads
+// @param z_dist sample of thresholds (dist = 'external' only)
+//
+// @return list with mean (vector), quantile (survival time x probability) and n_failed
+// [[Rcpp::export]]
+Rcpp::List guts_predictive_bands_engine(
+    Rcpp::List gobj,
+    Rcpp::NumericMatrix par,
+    Rcpp::NumericVector probs,
+    double compression,
+    int n_threads,
+    Rcpp::Nullable<Rcpp::NumericVector > z_dist = R_NilValue
+) {
+  const guts_native_data data = as_guts_native_data(gobj, z_dist);
+  const predictive_bands bands = run_predictive_bands(
+    data,
+    std::vector<double >(par.begin(), par.end()),
+    par.nrow(),
+    Rcpp::as<std::vector<double > >(probs),
+    compression,
+    n_threads
+  );
+  return Rcpp::List::create(
+    Rcpp::Named("mean") = bands.mean,
+    Rcpp::Named("quantile") = Rcpp::NumericMatrix(data.yt.size(), probs.size(), bands.quantile.begin()),
+    Rcpp::Named("n_failed") = static_cast<double >(bands.n_failed)
+  );
+}
@@ -0,0 +1,120 @@
+/**
+ * GUTS: Fast Calculation of the Likelihood of a Stochastic Survival Model.
+ * soeren.vogel@posteo.ch, carlo.albert@eawag.ch, alexander singer@rifcon.de, oliver.jakoby@rifcon.de, dirk.nickisch@rifcon.de
+ * License GPL-2
+ * 2026-10-19
+ */
+
+#ifndef GUTS_CACHE_H
+#define GUTS_CACHE_H
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <GUTS/guts_status.h>
+
+/**
+ * \brief Result of a projection as stored in GUTS objects
+ */
+struct cached_projection {
+  std::vector<double > S;
+  std::vector<double > D;
+  std::vector<double > Dt;
+  double LL;
+  guts_status status;
+};
+
+/**
+ * \brief Bounded least-recently-used cache of projections
+ * \details Entries are keyed on the exact bit pattern of the parameters, such that
+ * only identical parameter vectors are hits (e.g. the current state of a Metropolis
+ * chain after a rejection, or points revisited by line searches and scans).
+ * All entries belong to one external threshold sample: set_context() clears the
+ * cache if the sample differs from the one of the stored entries.
+ * Projections stopped early below a loglikelihood bound must not be inserted.
+ */
+class likelihood_cache {
+public:
+  explicit likelihood_cache(const std::size_t new_capacity) :
+    capacity(new_capacity), hits(0), misses(0), evictions(0) {}
+
+  /**
+   * \returns the key of parameters (their bytes)
+   */
+  static std::string key_of(const double* par, const std::size_t n) {
+    return std::string(reinterpret_cast<const char* >(par), n * sizeof(double));
+  }
+
+  /**
+   * \brief Use the entries of an external threshold sample (nullptr: none)
+   * \details Clears the cache if the sample differs bitwise from the previous one.
+   */
+  void set_context(const double* z_dist, const std::size_t n) {
+    const std::string context = (z_dist == nullptr) ? std::string() : key_of(z_dist, n);
+    if (context != z_dist_key) {
+      clear();
+      z_dist_key = context;
+    }
+  }
+
+  /**
+   * \returns the entry of a key or nullptr; counts the hit or miss
+   * \details A hit becomes the most recently used entry. The pointer is valid until the next insert().
+   */
+  const cached_projection* find(const std::string& key) {
+    const auto it = index.find(key);
+    if (it == index.end()) {
+      ++misses;
+      return nullptr;
+    }
+    ++hits;
+    entries.splice(entries.begin(), entries, it->second);
+    return &(it->second->second);
+  }
+
+  /**
+   * \brief Insert or replace an entry; evicts the least recently used entry if full
+   */
+  void insert(const std::string& key, cached_projection value) {
+    if (capacity == 0) return;
+    const auto it = index.find(key);
+    if (it != index.end()) {
+      it->second->second = std::move(value);
+      entries.splice(entries.begin(), entries, it->second);
+      return;
+    }
+    if (entries.size() >= capacity) {
+      index.erase(entries.back().first);
+      entries.pop_back();
+      ++evictions;
+    }
+    entries.emplace_front(key, std::move(value));
+    index[key] = entries.begin();
+  }
+
+  void clear() {
+    entries.clear();
+    index.clear();
+  }
+
+  std::size_t get_capacity() const {return capacity;}
+  std::size_t get_size() const {return entries.size();}
+  std::size_t get_hits() const {return hits;}
+  std::size_t get_misses() const {return misses;}
+  std::size_t get_evictions() const {return evictions;}
+
+private:
+  typedef std::list<std::pair<std::string, cached_projection > > tentries;
+  const std::size_t capacity;
+  // most recently used first
+  tentries entries;
+  std::unordered_map<std::string, tentries::iterator > index;
+  std::string z_dist_key;
+  std::size_t hits;
+  std::size_t misses;
+  std::size_t evictions;
+};
+
+#endif //GUTS_CACHE_H
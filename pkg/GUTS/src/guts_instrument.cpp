@@ -0,0 +1,112 @@
+/**
+ * GUTS: Fast Calculation of the Likelihood of a Stochastic Survival Model.
+ * soeren.vogel@posteo.ch, carlo.albert@eawag.ch, alexander singer@rifcon.de, oliver.jakoby@rifcon.de, dirk.nickisch@rifcon.de
+ * License GPL-2
+ * 2026-10-19
+ */
+
+#include <GUTS/guts_instrument.h>
+
+namespace {
+
+guts_instrument_totals zero_totals() {
+  guts_instrument_totals totals;
+  totals.counts.fill(0);
+  totals.calls.fill(0);
+  totals.seconds.fill(0.0);
+  return totals;
+}
+
+} // namespace
+
+#ifdef GUTS_INSTRUMENT
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+/**
+ * \brief Profiles of the running threads and the sum of the profiles of finished threads
+ */
+struct instrument_registry {
+  std::mutex mutex;
+  std::vector<guts_thread_instrument* > running;
+  guts_instrument_totals finished = zero_totals();
+};
+
+instrument_registry& registry() {
+  // never destroyed: threads may finish after static destruction
+  static instrument_registry* r = new instrument_registry();
+  return *r;
+}
+
+void add_to_totals(const guts_thread_instrument& profile, guts_instrument_totals& totals) {
+  for (std::size_t i = 0; i < totals.counts.size(); ++i) {
+    totals.counts[i] += profile.counts[i].load(std::memory_order_relaxed);
+  }
+  for (std::size_t i = 0; i < totals.calls.size(); ++i) {
+    totals.calls[i] += profile.calls[i].load(std::memory_order_relaxed);
+    totals.seconds[i] += 1e-9 * static_cast<double >(profile.nanoseconds[i].load(std::memory_order_relaxed));
+  }
+}
+
+void clear(guts_thread_instrument& profile) {
+  for (auto& a : profile.counts) a.store(0, std::memory_order_relaxed);
+  for (auto& a : profile.calls) a.store(0, std::memory_order_relaxed);
+  for (auto& a : profile.nanoseconds) a.store(0, std::memory_order_relaxed);
+}
+
+/**
+ * \brief Registers the profile of a thread, and adds it to the finished threads on exit
+ */
+struct thread_instrument_owner {
+  guts_thread_instrument profile;
+  thread_instrument_owner() {
+    clear(profile);
+    instrument_registry& r = registry();
+    std::lock_guard<std::mutex > lock(r.mutex);
+    r.running.push_back(&profile);
+  }
+  ~thread_instrument_owner() {
+    instrument_registry& r = registry();
+    std::lock_guard<std::mutex > lock(r.mutex);
+    add_to_totals(profile, r.finished);
+    r.running.erase(std::find(r.running.begin(), r.running.end(), &profile));
+  }
+};
+
+} // namespace
+
+guts_thread_instrument* guts_register_thread_instrument() {
+  thread_local thread_instrument_owner owner;
+  return &owner.profile;
+}
+
+bool guts_instrument_enabled() {return true;}
+
+guts_instrument_totals guts_instrument_collect() {
+  instrument_registry& r = registry();
+  std::lock_guard<std::mutex > lock(r.mutex);
+  guts_instrument_totals totals = r.finished;
+  for (const guts_thread_instrument* profile : r.running) add_to_totals(*profile, totals);
+  return totals;
+}
+
+void guts_instrument_reset() {
+  instrument_registry& r = registry();
+  std::lock_guard<std::mutex > lock(r.mutex);
+  r.finished = zero_totals();
+  for (guts_thread_instrument* profile : r.running) clear(*profile);
+}
+
+#else
+
+bool guts_instrument_enabled() {return false;}
+
+guts_instrument_totals guts_instrument_collect() {return zero_totals();}
+
+void guts_instrument_reset() {}
+
+#endif //GUTS_INSTRUMENT
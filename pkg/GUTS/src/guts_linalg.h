@@ -0,0 +1,97 @@
+/**
+ * GUTS: Fast Calculation of the Likelihood of a Stochastic Survival Model.
+ * soeren.vogel@posteo.ch, carlo.albert@eawag.ch, alexander singer@rifcon.de, oliver.jakoby@rifcon.de, dirk.nickisch@rifcon.de
+ * License GPL-2
+ * 2026-10-19
+ */
+
+#ifndef GUTS_LINALG_H
+#define GUTS_LINALG_H
+
+#include <cmath>
+#include <vector>
+
+/**
+ * Small dense matrices of parameter dimension, stored column-major
+ * (as R matrices): element (i,j) of a d x d matrix A is A[i + j*d].
+ */
+
+/**
+ * \brief Cholesky factorization A = L L^T
+ * \param[in] A symmetric d x d matrix
+ * \param[in] d dimension
+ * \param[out] L lower triangular factor (upper triangle set to 0)
+ * \returns false if A is not positive definite (L is undefined then)
+ */
+inline bool cholesky(const std::vector<double >& A, const std::size_t d, std::vector<double >& L) {
+  L.assign(d * d, 0.0);
+  for (std::size_t j = 0; j < d; ++j) {
+    double s = A[j + j*d];
+    for (std::size_t k = 0; k < j; ++k) s -= L[j + k*d] * L[j + k*d];
+    if (!(s > 0.0) || !std::isfinite(s)) return false;
+    const double Ljj = std::sqrt(s);
+    L[j + j*d] = Ljj;
+    for (std::size_t i = j + 1; i < d; ++i) {
+      double t = A[i + j*d];
+      for (std::size_t k = 0; k < j; ++k) t -= L[i + k*d] * L[j + k*d];
+      L[i + j*d] = t / Ljj;
+    }
+  }
+  return true;
+}
+
+/**
+ * \returns y = L x for a lower triangular d x d matrix L
+ */
+inline std::vector<double > lower_triangular_product(const std::vector<double >& L, const std::vector<double >& x) {
+  const std::size_t d = x.size();
+  std::vector<double > y(d, 0.0);
+  for (std::size_t j = 0; j < d; ++j) {
+    for (std::size_t i = j; i < d; ++i) y[i] += L[i + j*d] * x[j];
+  }
+  return y;
+}
+
+/**
+ * \returns A = L L^T for a lower triangular d x d matrix L
+ */
+inline std::vector<double > outer_product_of_factor(const std::vector<double >& L, const std::size_t d) {
+  std::vector<double > A(d * d, 0.0);
+  for (std::size_t i = 0; i < d; ++i) {
+    for (std::size_t j = 0; j <= i; ++j) {
+      double s = 0.0;
+      for (std::size_t k = 0; k <= j; ++k) s += L[i + k*d] * L[j + k*d];
+      A[i + j*d] = s;
+      A[j + i*d] = s;
+    }
+  }
+  return A;
+}
+
+/**
+ * \returns A^{-1} = L^{-T} L^{-1} for the Cholesky factor L of A (d x d)
+ */
+inline std::vector<double > cholesky_inverse(const std::vector<double >& L, const std::size_t d) {
+  // inverse of L (lower triangular) by forward substitution
+  std::vector<double > Li(d * d, 0.0);
+  for (std::size_t j = 0; j < d; ++j) {
+    Li[j + j*d] = 1.0 / L[j + j*d];
+    for (std::size_t i = j + 1; i < d; ++i) {
+      double s = 0.0;
+      for (std::size_t k = j; k < i; ++k) s -= L[i + k*d] * Li[k + j*d];
+      Li[i + j*d] = s / L[i + i*d];
+    }
+  }
+  std::vector<double > A(d * d, 0.0);
+  for (std::size_t i = 0; i < d; ++i) {
+    for (std::size_t j = 0; j <= i; ++j) {
+      double s = 0.0;
+      for (std::size_t k = i; k < d; ++k) s += Li[k + i*d] * Li[k + j*d];
+      A[i + j*d] = s;
+      A[j + i*d] = s;
+    }
+  }
+  return A;
+}
+
+#endif //GUTS_LINALG_H
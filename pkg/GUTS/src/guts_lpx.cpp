@@ -0,0 +1,693 @@
+/**
+ * GUTS: Fast Calculation of the Likelihood of a Stochastic Survival Model.
+ * soeren.vogel@posteo.ch, carlo.albert@eawag.ch, alexander singer@rifcon.de, oliver.jakoby@rifcon.de, dirk.nickisch@rifcon.de
+ * License GPL-2
+ * 2026-10-19
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include "guts_lpx.h"
+#include "guts_parallel.h"
+
+typedef std::vector<double > nvec;
+
+typedef external_data<nvec, nvec, true, true > lpx_dat_timediscrete_thresholddistdiscrete;
+typedef external_data<nvec, nvec, true, false > lpx_dat_timediscrete;
+typedef external_data<nvec, nvec, false, false > lpx_dat;
+
+namespace {
+
+/**
+ * \brief Calls visitor.apply<TD_mod, time_discrete>(dat, dtau) with the TD model and data of a data set
+ * \details dtau is the time step of time-discrete models (SD, proper) and 0 otherwise.
+ * \throws std::invalid_argument for unknown model and distribution combinations
+ */
+template<typename tResult, typename tVisitor >
+tResult visit_td_model(const guts_native_data& data, const tVisitor& visitor) {
+  switch (data.model) {
+  case TD_type::IT : {
+    lpx_dat dat;
+    dat.set_data_unchecked(data.Ct, data.C, data.yt, data.SVR);
+    switch (data.dist) {
+    case dist_type::LOGLOGISTIC :
+      return visitor.template apply<TD_IT_loglogistic, false >(dat, 0.0);
+    case dist_type::LOGNORMAL :
+      return visitor.template apply<TD_IT_lognormal, false >(dat, 0.0);
+    case dist_type::EXTERNAL :
+      return visitor.template apply<TD<random_sample<nvec >, 'I' >, false >(dat, 0.0);
+    default :
+      break;
+    }
+    break;
+  }
+  case TD_type::SD : {
+    lpx_dat_timediscrete dat;
+    dat.set_data_unchecked(data.Ct, data.C, data.yt, data.M, data.SVR);
+    return visitor.template apply<TD_SD, true >(dat, dat.calculate_dtau());
+  }
+  case TD_type::PROPER : {
+    switch (data.dist) {
+    case dist_type::LOGLOGISTIC : {
+      lpx_dat_timediscrete_thresholddistdiscrete dat;
+      dat.set_data_unchecked(data.Ct, data.C, data.yt, data.M, data.N, data.SVR);
+      if (data.quadrature) {
+        return visitor.template apply<TD_proper_quad_loglogistic, true >(dat, dat.calculate_dtau());
+      }
+      return visitor.template apply<TD_proper_loglogistic, true >(dat, dat.calculate_dtau());
+    }
+    case dist_type::LOGNORMAL : {
+      lpx_dat_timediscrete_thresholddistdiscrete dat;
+      dat.set_data_unchecked(data.Ct, data.C, data.yt, data.M, data.N, data.SVR);
+      if (data.quadrature) {
+        return visitor.template apply<TD_proper_quad_lognormal, true >(dat, dat.calculate_dtau());
+      }
+      return visitor.template apply<TD_proper_lognormal, true >(dat, dat.calculate_dtau());
+    }
+    case dist_type::DELTA : {
+      lpx_dat_timediscrete dat;
+      dat.set_data_unchecked(data.Ct, data.C, data.yt, data.M, data.SVR);
+      return visitor.template apply<TD_proper_delta, true >(dat, dat.calculate_dtau());
+    }
+    case dist_type::EXTERNAL : {
+      lpx_dat_timediscrete dat;
+      dat.set_data_unchecked(data.Ct, data.C, data.yt, data.M, data.SVR);
+      if (data.single_precision) {
+        return visitor.template apply<TD<random_sample<std::vector<float > >, 'P' >, true >(dat, dat.calculate_dtau());
+      }
+      return visitor.template apply<TD<random_sample<nvec >, 'P' >, true >(dat, dat.calculate_dtau());
+    }
+    }
+    break;
+  }
+  }
+  throw std::invalid_argument("Unknown combination of model and threshold distribution.");
+}
+
+/**
+ * \brief Root of effect(m) = x for an effect that increases with m >= 0 and is 0 at m = 0
+ * \details The bracket [0, 1] is doubled until it contains the root; then safeguarded
+ * regula falsi (Illinois) shrinks it to the relative tolerance tol.
+ * \returns the root; Inf if the effect is not reached, NaN if it is not defined
+ */
+template<typename tEffect >
+double solve_increasing_effect(const tEffect& effect, const double x, const double tol) {
+  const double max_factor = 1e15;
+  const std::size_t max_iter = 200;
+  double lo = 0.0, f_lo = -x;
+  double hi = 1.0, f_hi = effect(hi) - x;
+  while (!(f_hi >= 0.0)) {
+    if (std::isnan(f_hi)) return std::numeric_limits<double >::quiet_NaN();
+    if (hi > max_factor) return std::numeric_limits<double >::infinity();
+    lo = hi;
+    f_lo = f_hi;
+    hi *= 2.0;
+    f_hi = effect(hi) - x;
+  }
+  // Illinois: halve the function value of an endpoint that is retained twice
+  int retained = 0;
+  for (std::size_t i = 0; i < max_iter && hi - lo > tol * hi; ++i) {
+    double m = hi - f_hi * (hi - lo) / (f_hi - f_lo);
+    if (!(m > lo && m < hi)) m = 0.5 * (lo + hi);
+    const double f_m = effect(m) - x;
+    if (f_m >= 0.0) {
+      hi = m;
+      f_hi = f_m;
+      if (retained < 0) f_lo *= 0.5;
+      retained = -1;
+    } else {
+      lo = m;
+      f_lo = f_m;
+      if (retained > 0) f_hi *= 0.5;
+      retained = 1;
+    }
+  }
+  return 0.5 * (lo + hi);
+}
+
+/**
+ * \brief GUTS model whose TD part is fed with a scaled damage trajectory
+ */
+template<typename TD_mod >
+class lpx_model : public guts_RED<nvec, nvec, TD_mod, nvec > {
+public:
+  typedef typename guts_RED<nvec, nvec, TD_mod, nvec >::TK_mod TK_mod;
+  /**
+   * \brief damage at the discrete time steps of guts_projector before t_end
+   */
+  void calculate_damage_trajectory(const std::size_t M, const double dtau, const double t_end, std::vector<double >& D) const {
+    TK_mod::set_start_conditions();
+    D.clear();
+    std::size_t k = 0;
+    double tau = 0.0;
+    for (std::size_t i = 0; i < M && tau < t_end; ) {
+      GUTS_INSTRUMENT_COUNT(time_steps, 1);
+      D.push_back(TK_mod::calculate_damage(k, tau));
+      tau = dtau * static_cast<double >(++i);
+      if (k + 2 < this->Ct->size() && tau > this->Ct->at(k+1)) {
+        ++k;
+        this->update_to_next_concentration_measurement();
+      }
+    }
+  }
+  /**
+   * \brief damage at the times Ct[0] + i dtau, i = 0, ..., n - 1
+   * \details Damage is calculated exactly at concentration measurements.
+   */
+  void calculate_damage_grid(const double dtau, const std::size_t n, std::vector<double >& D) const {
+    TK_mod::set_start_conditions();
+    D.resize(n);
+    std::size_t k = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+      const double t = this->Ct->front() + dtau * static_cast<double >(i);
+      while (k + 2 < this->Ct->size() && t > this->Ct->at(k+1)) {
+        TK_mod::calculate_damage(k, this->Ct->at(k+1));
+        ++k;
+        this->update_to_next_concentration_measurement();
+      }
+      D[i] = TK_mod::calculate_damage(k, t);
+    }
+  }
+  /**
+   * \brief maximum damage up to t_end, from the boundaries and extreme values of each concentration interval
+   */
+  double calculate_maximum_damage(const double t_end) const {
+    TK_mod::set_start_conditions();
+    double D_max = 0.0;
+    for (std::size_t k = 0; ; ++k) {
+      const bool last = k + 2 >= this->Ct->size() || this->Ct->at(k+1) >= t_end;
+      const double t_next = last ? t_end : this->Ct->at(k+1);
+      // minima do not change the maximum
+      const double te = TK_mod::calculate_time_of_extreme_damage(k);
+      if (te > this->Ct->at(k) && te < t_next) D_max = std::max(D_max, TK_mod::calculate_damage(k, te));
+      D_max = std::max(D_max, TK_mod::calculate_damage(k, t_next));
+      if (last) break;
+      this->update_to_next_concentration_measurement();
+    }
+    return D_max;
+  }
+  /**
+   * \returns the logarithm of the survival at t_end by damage D times mf
+   */
+  double log_survival(const std::vector<double >& D, const double mf, const double t_end) const {
+    TD_mod::set_start_conditions();
+    if (mf > 0.0) {
+      for (const double d : D) TD_mod::gather_effect(mf * d);
+    }
+    GUTS_INSTRUMENT_COUNT(survival, 1);
+    return TD_mod::calculate_current_log_survival(t_end);
+  }
+};
+
+template<typename TD_mod, bool time_discrete >
+class lpx_model_solver : public guts_lpx_solver {
+public:
+  template<typename tData >
+  lpx_model_solver(const tData& data, const guts_native_data& native_data, const double new_dtau) :
+    data_settings(native_data), dtau(new_dtau), t_end(native_data.yt.back())
+  {
+    model.initialize(data);
+  }
+  guts_status solve(
+      const std::vector<double >& par,
+      const std::vector<double >& effects,
+      const double tol,
+      std::vector<double >& mf
+  ) override {
+    mf.assign(effects.size(), std::numeric_limits<double >::quiet_NaN());
+    survival = std::numeric_limits<double >::quiet_NaN();
+    map_guts_parameters(data_settings, par, full_par);
+    model.set_parameters(full_par);
+    const guts_status status = model.check_parameters();
+    if (status != guts_status::ok) return status;
+    model.initialize_from_parameters();
+    if (time_discrete) {
+      model.calculate_damage_trajectory(data_settings.M, dtau, t_end, D);
+    } else {
+      D.assign(1, model.calculate_maximum_damage(t_end));
+    }
+    log_S0 = model.log_survival(D, 0.0, t_end);
+    if (!std::isfinite(log_S0)) return guts_status::survival_underflow;
+    survival = std::exp(model.log_survival(D, 1.0, t_end) - log_S0);
+    for (std::size_t i = 0; i < effects.size(); ++i) {
+      mf[i] = solve_increasing_effect([this](const double m) {return effect(m);}, effects[i], tol);
+    }
+    return guts_status::ok;
+  }
+  double get_relative_survival() const override {return survival;}
+private:
+  lpx_model<TD_mod > model;
+  const guts_native_data data_settings;
+  const double dtau;
+  const double t_end;
+  std::vector<double > full_par;
+  std::vector<double > D;
+  double log_S0;
+  double survival;
+  inline double effect(const double mf) const {
+    return -std::expm1(model.log_survival(D, mf, t_end) - log_S0);
+  }
+};
+
+struct lpx_solver_factory {
+  const guts_native_data& data;
+  template<typename TD_mod, bool time_discrete, typename tData >
+  std::unique_ptr<guts_lpx_solver > apply(const tData& dat, const double dtau) const {
+    return std::unique_ptr<guts_lpx_solver >(new lpx_model_solver<TD_mod, time_discrete >(dat, data, dtau));
+  }
+};
+
+/**
+ * \returns \f$ \int_0^t \max(0, D(s) - z) ds \f$ for \f$ D(s) = C (1 - e^{-k s}) \f$
+ */
+double integrate_damage_above_threshold(const double C, const double k, const double z, const double t) {
+  if (!(k > 0.0)) return z < 0.0 ? -z * t : 0.0;
+  // time at which damage reaches the threshold
+  double tz = 0.0;
+  if (z > 0.0) {
+    if (C <= z) return 0.0;
+    tz = -std::log1p(-z / C) / k;
+    if (t <= tz) return 0.0;
+  }
+  // D(tz) = max(z, 0)
+  const double Dz = std::max(z, 0.0);
+  return (C - z) * (t - tz) - (C - Dz - C * std::exp(-k * t)) / k;
+}
+
+// relative survival of constant exposure with damage D = D(t), see guts_constant_exposure
+inline double constant_exposure_survival(const TD_SD& td, const double C, const double k, const double t, const double) {
+  return std::exp(-td.get_killing_rate() * integrate_damage_above_threshold(C, k, td.get_threshold(), t));
+}
+template<typename sampler >
+double constant_exposure_survival(const TD_proper_impsampling<sampler >& td, const double C, const double k, const double t, const double) {
+  // importance weights are not normalized
+  double S = 0.0, W = 0.0;
+  for (std::size_t u = 0; u < td.samp.sample_size(); ++u) {
+    const double w = std::exp(td.samp.weight_at(u));
+    S += w * std::exp(-td.get_killing_rate() * integrate_damage_above_threshold(C, k, td.samp.variate_at(u), t));
+    W += w;
+  }
+  return S / W;
+}
+template<typename tz >
+double constant_exposure_survival(const TD<random_sample<tz >, 'P' >& td, const double C, const double k, const double t, const double) {
+  double S = 0.0;
+  for (std::size_t u = 0; u < td.samp.sample_size(); ++u) {
+    S += std::exp(-td.get_killing_rate() * integrate_damage_above_threshold(C, k, td.samp.variate_at(u), t));
+  }
+  return S / static_cast<double >(td.samp.sample_size());
+}
+template<typename dist >
+inline double constant_exposure_survival(const TD<dist, 'I' >& td, const double, const double, const double, const double D) {
+  return 1.0 - td.samp.CDF(D);
+}
+template<typename tz >
+double constant_exposure_survival(const TD<random_sample<tz >, 'I' >& td, const double, const double, const double, const double D) {
+  // as TD_IT_base::gather_effect, individuals with z >= D survive
+  return static_cast<double >(td.samp.end() - std::lower_bound(td.samp.begin(), td.samp.end(), D)) /
+    static_cast<double >(td.samp.sample_size());
+}
+
+template<typename TD_mod >
+class constant_exposure_model : public guts_constant_exposure {
+public:
+  template<typename tData >
+  constant_exposure_model(const tData& data, const guts_native_data& native_data) :
+    data_settings(native_data), k(std::numeric_limits<double >::quiet_NaN()), status(guts_status::ok)
+  {
+    model.initialize(data);
+  }
+  guts_status set_parameters(const std::vector<double >& par) override {
+    map_guts_parameters(data_settings, par, full_par);
+    model.set_parameters(full_par);
+    status = model.check_parameters();
+    if (status != guts_status::ok) return status;
+    model.initialize_from_parameters();
+    // draws the importance sample of proper models
+    model.TD_mod::set_start_conditions();
+    k = model.get_dominant_rate_constant() * data_settings.SVR;
+    return status;
+  }
+  double calculate_relative_survival(const double C, const double t) const override {
+    if (status != guts_status::ok) return std::numeric_limits<double >::quiet_NaN();
+    const double D = k > 0.0 ? -C * std::expm1(-k * t) : 0.0;
+    return constant_exposure_survival(static_cast<const TD_mod& >(model), C, k, t, D);
+  }
+  double get_background_mortality() const override {return full_par.at(0);}
+private:
+  guts_RED<nvec, nvec, TD_mod, nvec > model;
+  const guts_native_data data_settings;
+  std::vector<double > full_par;
+  double k;
+  guts_status status;
+};
+
+struct constant_exposure_factory {
+  const guts_native_data& data;
+  template<typename TD_mod, bool, typename tData >
+  std::unique_ptr<guts_constant_exposure > apply(const tData& dat, const double) const {
+    return std::unique_ptr<guts_constant_exposure >(new constant_exposure_model<TD_mod >(dat, data));
+  }
+};
+
+} // namespace
+
+std::unique_ptr<guts_lpx_solver > make_guts_lpx_solver(const guts_native_data& data) {
+  return visit_td_model<std::unique_ptr<guts_lpx_solver > >(data, lpx_solver_factory{data});
+}
+
+std::vector<double > run_lpx(
+    const guts_native_data& data,
+    const std::vector<double >& par,
+    const std::size_t n,
+    const std::vector<double >& effects,
+    const double tol,
+    const std::size_t n_threads
+) {
+  const std::size_t d = n > 0 ? par.size() / n : 0;
+  const std::size_t n_solvers = std::max<std::size_t >(1, std::min(n_threads, n));
+  std::vector<std::unique_ptr<guts_lpx_solver > > solvers(n_solvers);
+  for (auto& solver : solvers) solver = make_guts_lpx_solver(data);
+  std::vector<double > result(n * effects.size(), std::numeric_limits<double >::quiet_NaN());
+  // task i always runs in thread i % n_solvers, see parallel_for
+  parallel_for(n, n_solvers, [&](const std::size_t i) {
+    std::vector<double > p(d), mf;
+    for (std::size_t j = 0; j < d; ++j) p[j] = par[i + j*n];
+    solvers[i % n_solvers]->solve(p, effects, tol, mf);
+    for (std::size_t e = 0; e < effects.size(); ++e) result[i + e*n] = mf[e];
+  });
+  return result;
+}
+
+double guts_constant_exposure::calculate_lcx(const double effect, const double t, const double tol) const {
+  return solve_increasing_effect(
+    [this, t](const double C) {return 1.0 - calculate_relative_survival(C, t);}, effect, tol
+  );
+}
+
+std::unique_ptr<guts_constant_exposure > make_guts_constant_exposure(const guts_native_data& data) {
+  return visit_td_model<std::unique_ptr<guts_constant_exposure > >(data, constant_exposure_factory{data});
+}
+
+namespace {
+
+/**
+ * \brief Run fun(model, p, i) for each row i of the n x d parameter matrix par in parallel
+ * \details One model per thread; task i always runs in thread i % n_models, see parallel_for.
+ */
+template<typename tFun >
+void for_each_constant_exposure_parameter(
+    const guts_native_data& data,
+    const std::vector<double >& par,
+    const std::size_t n,
+    const std::size_t n_threads,
+    const tFun& fun
+) {
+  const std::size_t d = n > 0 ? par.size() / n : 0;
+  const std::size_t n_models = std::max<std::size_t >(1, std::min(n_threads, n));
+  std::vector<std::unique_ptr<guts_constant_exposure > > models(n_models);
+  for (auto& model : models) model = make_guts_constant_exposure(data);
+  parallel_for(n, n_models, [&](const std::size_t i) {
+    std::vector<double > p(d);
+    for (std::size_t j = 0; j < d; ++j) p[j] = par[i + j*n];
+    guts_constant_exposure& model = *models[i % n_models];
+    if (model.set_parameters(p) == guts_status::ok) fun(model, i);
+  });
+}
+
+} // namespace
+
+std::vector<double > run_constant_exposure_survival(
+    const guts_native_data& data,
+    const std::vector<double >& par,
+    const std::size_t n,
+    const std::vector<double >& C,
+    const std::vector<double >& t,
+    const std::size_t n_threads
+) {
+  const std::size_t nC = C.size();
+  std::vector<double > S(n * nC * t.size(), std::numeric_limits<double >::quiet_NaN());
+  for_each_constant_exposure_parameter(data, par, n, n_threads, [&](const guts_constant_exposure& model, const std::size_t i) {
+    const double hb = model.get_background_mortality();
+    for (std::size_t it = 0; it < t.size(); ++it) {
+      for (std::size_t ic = 0; ic < nC; ++ic) {
+        S[i + n * (ic + nC * it)] = std::exp(-hb * t[it]) * model.calculate_relative_survival(C[ic], t[it]);
+      }
+    }
+  });
+  return S;
+}
+
+std::vector<double > run_lcx(
+    const guts_native_data& data,
+    const std::vector<double >& par,
+    const std::size_t n,
+    const std::vector<double >& effects,
+    const std::vector<double >& t,
+    const double tol,
+    const std::size_t n_threads
+) {
+  const std::size_t nt = t.size();
+  std::vector<double > LC(n * nt * effects.size(), std::numeric_limits<double >::quiet_NaN());
+  for_each_constant_exposure_parameter(data, par, n, n_threads, [&](const guts_constant_exposure& model, const std::size_t i) {
+    for (std::size_t e = 0; e < effects.size(); ++e) {
+      for (std::size_t it = 0; it < nt; ++it) {
+        LC[i + n * (it + nt * e)] = model.calculate_lcx(effects[e], t[it], tol);
+      }
+    }
+  });
+  return LC;
+}
+
+namespace {
+
+struct window_scanner {
+  const guts_native_data& data;
+  const std::vector<double >& par;
+  const double window;
+  const std::vector<double >& starts;
+  const std::vector<double >& effects;
+  const double tol;
+  const std::size_t n_threads;
+  template<typename TD_mod, bool time_discrete, typename tData >
+  window_scan_result apply(const tData& dat, const double) const {
+    const std::size_t M = data.M;
+    const std::size_t n_windows = starts.size();
+    const double dtau = window / static_cast<double >(M);
+    const double t0 = data.Ct.front();
+    // number of grid points of the profile
+    const std::size_t n_grid = static_cast<std::size_t >(std::floor((data.Ct.back() - t0) / dtau + 1e-9)) + 1;
+
+    window_scan_result result;
+    std::vector<std::size_t > first(n_windows);
+    for (std::size_t w = 0; w < n_windows; ++w) {
+      const double a = std::round((starts[w] - t0) / dtau);
+      if (!(a >= 0.0) || a + static_cast<double >(M) > static_cast<double >(n_grid - 1)) {
+        throw std::invalid_argument("Windows must be within the exposure profile.");
+      }
+      first[w] = static_cast<std::size_t >(a);
+      result.start.push_back(t0 + dtau * a);
+    }
+    result.survival.assign(n_windows, std::numeric_limits<double >::quiet_NaN());
+    result.mf.assign(n_windows * effects.size(), std::numeric_limits<double >::quiet_NaN());
+
+    std::vector<double > full_par;
+    map_guts_parameters(data, par, full_par);
+    const std::size_t n_models = std::max<std::size_t >(1, std::min(n_threads, n_windows));
+    std::vector<std::unique_ptr<lpx_model<TD_mod > > > models(n_models);
+    for (auto& model : models) {
+      model.reset(new lpx_model<TD_mod >());
+      model->initialize(dat);
+      model->set_parameters(full_par);
+      if (model->check_parameters() != guts_status::ok) return result;
+      model->initialize_from_parameters();
+    }
+
+    // damage of the full profile and decay of the damage at window starts
+    std::vector<double > D_full, decay(M + 1);
+    models.front()->calculate_damage_grid(dtau, n_grid, D_full);
+    const double k = models.front()->get_dominant_rate_constant() * data.SVR;
+    for (std::size_t i = 0; i <= M; ++i) decay[i] = std::exp(-k * dtau * static_cast<double >(i));
+    const double log_S0 = models.front()->log_survival(std::vector<double >(), 0.0, window);
+
+    std::vector<std::vector<double > > D(n_models);
+    // task w always runs in thread w % n_models, see parallel_for
+    parallel_for(n_windows, n_models, [&](const std::size_t w) {
+      const lpx_model<TD_mod >& model = *models[w % n_models];
+      std::vector<double >& Dw = D[w % n_models];
+      const double* Df = D_full.data() + first[w];
+      if (time_discrete) {
+        Dw.resize(M);
+        for (std::size_t i = 0; i < M; ++i) Dw[i] = Df[i] - Df[0] * decay[i];
+      } else {
+        double D_max = 0.0;
+        for (std::size_t i = 0; i <= M; ++i) D_max = std::max(D_max, Df[i] - Df[0] * decay[i]);
+        Dw.assign(1, D_max);
+      }
+      auto effect = [&](const double mf) {return -std::expm1(model.log_survival(Dw, mf, window) - log_S0);};
+      result.survival[w] = 1.0 - effect(1.0);
+      for (std::size_t e = 0; e < effects.size(); ++e) {
+        result.mf[w + e * n_windows] = solve_increasing_effect(effect, effects[e], tol);
+      }
+    });
+    return result;
+  }
+};
+
+} // namespace
+
+window_scan_result run_window_scan(
+    const guts_native_data& data,
+    const std::vector<double >& par,
+    const double window,
+    const std::vector<double >& starts,
+    const std::vector<double >& effects,
+    const double tol,
+    const std::size_t n_threads
+) {
+  if (!(window > 0.0) || data.M == 0 || data.Ct.size() < 2) {
+    throw std::invalid_argument("The window and the exposure profile must not be empty.");
+  }
+  // survival at the window end determines the time step of time-discrete models
+  guts_native_data window_data = data;
+  window_data.yt = {0.0, window};
+  return visit_td_model<window_scan_result >(
+    window_data, window_scanner{window_data, par, window, starts, effects, tol, n_threads}
+  );
+}
+
+namespace {
+
+/**
+ * \brief Calls fun(p, first, last, t) for blocks [first, last) of the n parameter sets of each profile p
+ * \details Blocks of long profiles come first; blocks are balanced by parallel_for_stealing.
+ * prepare(p, t) is called before thread t (t < max(1, n_threads)) turns to a block of another profile,
+ * such that per-profile workspace is reused for consecutive blocks of the same profile.
+ */
+template<typename tPrepare, typename tFun >
+void for_each_profile_block(
+    const std::vector<guts_native_data >& profiles,
+    const std::size_t n,
+    const std::size_t n_threads,
+    tPrepare prepare,
+    tFun fun
+) {
+  const std::size_t block_size = 16;
+  const std::size_t n_profiles = profiles.size();
+  const std::size_t n_blocks = (n + block_size - 1) / block_size;
+  // profiles by decreasing cost of a projection
+  std::vector<std::size_t > order(n_profiles);
+  std::vector<std::size_t > cost(n_profiles);
+  for (std::size_t p = 0; p < n_profiles; ++p) {
+    order[p] = p;
+    cost[p] = profiles[p].Ct.size() + profiles[p].yt.size() + (profiles[p].model == TD_type::IT ? 0 : profiles[p].M);
+  }
+  std::stable_sort(order.begin(), order.end(), [&cost](const std::size_t a, const std::size_t b) {return cost[a] > cost[b];});
+
+  std::vector<std::size_t > current(std::max<std::size_t >(1, n_threads), n_profiles);
+  parallel_for_stealing(n_profiles * n_blocks, n_threads, [&](const std::size_t task, const std::size_t t) {
+    const std::size_t p = order[task / n_blocks];
+    if (current[t] != p) {
+      prepare(p, t);
+      current[t] = p;
+    }
+    const std::size_t first = (task % n_blocks) * block_size;
+    fun(p, first, std::min(n, first + block_size), t);
+  });
+}
+
+} // namespace
+
+exposure_batch_result run_exposure_batch(
+    const std::vector<guts_native_data >& profiles,
+    const std::vector<double >& par,
+    const std::size_t n,
+    const std::vector<double >& effects,
+    const double tol,
+    const std::size_t n_threads,
+    guts_result_sink* sink
+) {
+  const std::size_t n_profiles = profiles.size();
+  const std::size_t d = n > 0 ? par.size() / n : 0;
+  exposure_batch_result result;
+  if (!sink) {
+    result.survival.assign(n_profiles * n, std::numeric_limits<double >::quiet_NaN());
+    result.mf.assign(n_profiles * n * effects.size(), std::numeric_limits<double >::quiet_NaN());
+  }
+  std::vector<std::unique_ptr<guts_lpx_solver > > solvers(std::max<std::size_t >(1, n_threads));
+  for_each_profile_block(profiles, n, n_threads,
+    [&](const std::size_t p, const std::size_t t) {solvers[t] = make_guts_lpx_solver(profiles[p]);},
+    [&](const std::size_t p, const std::size_t first, const std::size_t last, const std::size_t t) {
+      std::vector<double > q(d), mf;
+      std::vector<double > survival(last - first), block_mf((last - first) * effects.size());
+      for (std::size_t i = first; i < last; ++i) {
+        for (std::size_t j = 0; j < d; ++j) q[j] = par[i + j*n];
+        solvers[t]->solve(q, effects, tol, mf);
+        survival[i - first] = solvers[t]->get_relative_survival();
+        for (std::size_t e = 0; e < effects.size(); ++e) block_mf[i - first + (last - first) * e] = mf[e];
+      }
+      if (sink) {
+        // rows by profile and parameter set
+        const std::uint64_t row = static_cast<std::uint64_t >(p) * n + first;
+        std::vector<std::int32_t > profile(last - first, p + 1), sample(last - first);
+        for (std::size_t i = first; i < last; ++i) sample[i - first] = i + 1;
+        sink->write(0, row, profile.data(), profile.size());
+        sink->write(1, row, sample.data(), sample.size());
+        sink->write(2, row, survival.data(), survival.size());
+        for (std::size_t e = 0; e < effects.size(); ++e) {
+          sink->write(3 + e, row, block_mf.data() + (last - first) * e, last - first);
+        }
+      } else {
+        for (std::size_t i = first; i < last; ++i) {
+          result.survival[p + n_profiles * i] = survival[i - first];
+          for (std::size_t e = 0; e < effects.size(); ++e) {
+            result.mf[p + n_profiles * (i + n * e)] = block_mf[i - first + (last - first) * e];
+          }
+        }
+      }
+    }
+  );
+  return result;
+}
+
+void run_survival_batch(
+    const std::vector<guts_native_data >& data,
+    const std::vector<double >& par,
+    const std::size_t n,
+    guts_result_sink& sink,
+    const std::size_t n_threads
+) {
+  const std::size_t d = n > 0 ? par.size() / n : 0;
+  // first row of each data set
+  std::vector<std::uint64_t > first_row(data.size() + 1, 0);
+  for (std::size_t p = 0; p < data.size(); ++p) first_row[p+1] = first_row[p] + static_cast<std::uint64_t >(n) * data[p].yt.size();
+  if (first_row.back() != sink.get_n_rows()) throw std::invalid_argument("Wrong number of rows of the result file.");
+  std::vector<std::unique_ptr<guts_evaluator > > evaluators(std::max<std::size_t >(1, n_threads));
+  for_each_profile_block(data, n, n_threads,
+    [&](const std::size_t p, const std::size_t t) {evaluators[t] = make_guts_evaluator(data[p]);},
+    [&](const std::size_t p, const std::size_t first, const std::size_t last, const std::size_t t) {
+      const std::vector<double >& yt = data[p].yt;
+      const std::size_t rows = (last - first) * yt.size();
+      std::vector<double > q(d), S;
+      std::vector<std::int32_t > profile(rows, p + 1), sample(rows);
+      std::vector<double > time(rows), survival(rows);
+      for (std::size_t i = first; i < last; ++i) {
+        for (std::size_t j = 0; j < d; ++j) q[j] = par[i + j*n];
+        evaluators[t]->calc_survival(q, S);
+        const std::size_t r = (i - first) * yt.size();
+        for (std::size_t k = 0; k < yt.size(); ++k) {
+          sample[r + k] = i + 1;
+          time[r + k] = yt[k];
+          survival[r + k] = S[k];
+        }
+      }
+      const std::uint64_t row = first_row[p] + static_cast<std::uint64_t >(first) * yt.size();
+      sink.write(0, row, profile.data(), rows);
+      sink.write(1, row, sample.data(), rows);
+      sink.write(2, row, time.data(), rows);
+      sink.write(3, row, survival.data(), rows);
+    }
+  );
+}
@@ -0,0 +1,215 @@
+/**
+ * GUTS: Fast Calculation of the Likelihood of a Stochastic Survival Model.
+ * soeren.vogel@posteo.ch, carlo.albert@eawag.ch, alexander singer@rifcon.de, oliver.jakoby@rifcon.de, dirk.nickisch@rifcon.de
+ * License GPL-2
+ * 2026-10-19
+ */
+
+#ifndef GUTS_LPX_H
+#define GUTS_LPX_H
+
+#include <memory>
+#include <vector>
+#include "guts_native.h"
+#include "guts_sink.h"
+#include <GUTS/guts_status.h>
+
+/**
+ * \brief Multiplication factors of an exposure profile that cause given effects
+ * \details The effect of a multiplication factor MF is the relative reduction of survival
+ * at the last survival time by the profile MF * C, compared to the control (C = 0):
+ * \f$ 1 - S(t_{end}; MF C) / S(t_{end}; 0) \f$. The effect does not depend on background mortality.
+ *
+ * TK-RED is linear in C with D(0) = 0. Hence, the damage of MF * C is MF times the damage of C.
+ * A solver calculates the damage of C once per parameter set and finds each MF on this trajectory
+ * by safeguarded regula falsi (Illinois), rerunning only the TD part of the model.
+ * A solver is not thread-safe. Use one solver per thread.
+ */
+class guts_lpx_solver {
+public:
+  virtual ~guts_lpx_solver() {}
+  /**
+   * \param[in] par parameters as used by guts_calc_loglikelihood
+   * \param[in] effects effects in (0, 1), e.g. 0.5 for LP50
+   * \param[in] tol relative tolerance of MF
+   * \param[out] mf multiplication factors; Inf if an effect is not reached, NaN on failure
+   * \returns guts_status::ok or the reason of a failure
+   */
+  virtual guts_status solve(
+      const std::vector<double >& par,
+      const std::vector<double >& effects,
+      const double tol,
+      std::vector<double >& mf
+  ) = 0;
+  /**
+   * \returns the relative survival at the last survival time by C (MF = 1) of the last solved parameters; NaN on failure
+   */
+  virtual double get_relative_survival() const = 0;
+};
+
+/**
+ * \brief Create a solver of multiplication factors of the exposure profile of a data set
+ * \throws std::invalid_argument for unknown model and distribution combinations
+ */
+std::unique_ptr<guts_lpx_solver > make_guts_lpx_solver(const guts_native_data& data);
+
+/**
+ * \brief Multiplication factors of parameter samples, solved in parallel
+ * \param[in] par n x d matrix of parameters (column-major)
+ * \param[in] n number of parameter sets
+ * \returns n x length(effects) matrix of multiplication factors (column-major)
+ */
+std::vector<double > run_lpx(
+    const guts_native_data& data,
+    const std::vector<double >& par,
+    const std::size_t n,
+    const std::vector<double >& effects,
+    const double tol,
+    const std::size_t n_threads
+);
+
+/**
+ * \brief Survival under constant exposure in closed form
+ * \details For a constant concentration C, scaled damage is \f$ D(t) = C (1 - e^{-k_d t}) \f$
+ * (k_d including SVR). Survival relative to the control is
+ *   - SD: \f$ \exp(-k_k \int_0^t \max(0, D(s) - z) ds) \f$, with the integral in closed form,
+ *   - proper: the (importance weighted) mean of the SD survival over the threshold sample,
+ *   - IT: \f$ 1 - F(D(t)) \f$, as damage increases monotonically.
+ * The proper model is continuous in time here; guts_projector uses M discrete time steps.
+ * An object is not thread-safe. Use one object per thread.
+ */
+class guts_constant_exposure {
+public:
+  virtual ~guts_constant_exposure() {}
+  /**
+   * \param[in] par parameters as used by guts_calc_loglikelihood
+   * \returns guts_status::ok or the reason of invalid parameters
+   */
+  virtual guts_status set_parameters(const std::vector<double >& par) = 0;
+  /**
+   * \returns survival at time t relative to the control (without background mortality)
+   */
+  virtual double calculate_relative_survival(const double C, const double t) const = 0;
+  virtual double get_background_mortality() const = 0;
+  /**
+   * \returns the concentration that reduces survival at time t by effect (in (0, 1)); Inf if not reached
+   */
+  double calculate_lcx(const double effect, const double t, const double tol) const;
+};
+
+/**
+ * \brief Create the constant exposure model of the model and threshold distribution of a data set
+ * \throws std::invalid_argument for unknown model and distribution combinations
+ */
+std::unique_ptr<guts_constant_exposure > make_guts_constant_exposure(const guts_native_data& data);
+
+/**
+ * \brief Survival under constant exposure on a grid of concentrations and times, for parameter samples in parallel
+ * \param[in] par n x d matrix of parameters (column-major)
+ * \returns n x length(C) x length(t) array of survival including background mortality (column-major)
+ */
+std::vector<double > run_constant_exposure_survival(
+    const guts_native_data& data,
+    const std::vector<double >& par,
+    const std::size_t n,
+    const std::vector<double >& C,
+    const std::vector<double >& t,
+    const std::size_t n_threads
+);
+
+/**
+ * \brief Lethal concentrations LCx(t) of constant exposure, for parameter samples in parallel
+ * \param[in] par n x d matrix of parameters (column-major)
+ * \returns n x length(t) x length(effects) array of concentrations (column-major); NaN for invalid parameters
+ */
+std::vector<double > run_lcx(
+    const guts_native_data& data,
+    const std::vector<double >& par,
+    const std::size_t n,
+    const std::vector<double >& effects,
+    const std::vector<double >& t,
+    const double tol,
+    const std::size_t n_threads
+);
+
+/**
+ * \brief Survival and multiplication factors of windows of an exposure profile
+ * \details start: window starts on the time grid; survival: survival at the end of each window
+ * relative to the control; mf: n_windows x length(effects) multiplication factors (column-major),
+ * see guts_lpx_solver.
+ */
+struct window_scan_result {
+  std::vector<double > start;
+  std::vector<double > survival;
+  std::vector<double > mf;
+};
+
+/**
+ * \brief Scan an exposure profile with windows of fixed length
+ * \details Each window starts without damage. The profile data.Ct, data.C is discretized with
+ * dtau = window / data.M, and the damage of the full profile is calculated once. TK-RED is linear,
+ * hence, the damage of the window starting at s is \f$ D(t) - D(s) e^{-k_d (t - s)} \f$, and windows
+ * only rerun the TD part of the model. Windows run in parallel, one model per thread.
+ * For model IT, the maximum damage of a window is taken on the time grid.
+ * \param[in] starts window starts, rounded to the time grid
+ * \throws std::invalid_argument if a window is not within the profile
+ */
+window_scan_result run_window_scan(
+    const guts_native_data& data,
+    const std::vector<double >& par,
+    const double window,
+    const std::vector<double >& starts,
+    const std::vector<double >& effects,
+    const double tol,
+    const std::size_t n_threads
+);
+
+/**
+ * \brief Relative survival and multiplication factors of exposure profiles for parameter samples
+ * \details survival: n_profiles x n matrix; mf: n_profiles x n x length(effects) array (column-major).
+ */
+struct exposure_batch_result {
+  std::vector<double > survival;
+  std::vector<double > mf;
+};
+
+/**
+ * \brief Evaluate each exposure profile with each parameter set in parallel
+ * \details A task is a block of parameter sets of one profile. Tasks are ordered by decreasing
+ * profile size and balanced by work stealing (see parallel_for_stealing). Threads keep the solver
+ * of their current profile, such that the preprocessing of a profile (interval table of the
+ * exposure) is shared by all parameter sets of consecutive tasks. See guts_lpx_solver.
+ * \param[in] profiles data sets of the profiles, with survival evaluated at the last element of yt
+ * \param[in] par n x d matrix of parameters (column-major)
+ * \param[in] sink result file with n_profiles x n rows (by profile, then parameter set) and columns
+ * profile, sample (int32, 1-based), survival and one column per effect (float64); NULL: results are returned
+ * \returns the results; empty if written to sink
+ */
+exposure_batch_result run_exposure_batch(
+    const std::vector<guts_native_data >& profiles,
+    const std::vector<double >& par,
+    const std::size_t n,
+    const std::vector<double >& effects,
+    const double tol,
+    const std::size_t n_threads,
+    guts_result_sink* sink = nullptr
+);
+
+/**
+ * \brief Survival at the survival times of each data set with each parameter set, written to a result file
+ * \details Scheduled as run_exposure_batch, with one evaluator per thread and data set
+ * (see guts_evaluator::calc_survival). Each block of parameter sets is written as one chunk per column.
+ * \param[in] par n x d matrix of parameters (column-major)
+ * \param[in] sink result file with n sum(length(yt)) rows (by data set, parameter set and survival time)
+ * and columns profile, sample (int32, 1-based), time and survival (float64); survival is NaN on failure
+ * \throws std::invalid_argument if the number of rows of sink does not match
+ */
+void run_survival_batch(
+    const std::vector<guts_native_data >& data,
+    const std::vector<double >& par,
+    const std::size_t n,
+    guts_result_sink& sink,
+    const std::size_t n_threads
+);
+
+#endif //GUTS_LPX_H
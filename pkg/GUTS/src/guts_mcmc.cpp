@@ -0,0 +1,215 @@
+/**
+ * GUTS: Fast Calculation of the Likelihood of a Stochastic Survival Model.
+ * soeren.vogel@posteo.ch, carlo.albert@eawag.ch, alexander singer@rifcon.de, oliver.jakoby@rifcon.de, dirk.nickisch@rifcon.de
+ * License GPL-2
+ * 2026-10-19
+ */
+
+#include <algorithm>
+#include <stdexcept>
+#include "guts_mcmc.h"
+#include "guts_linalg.h"
+#include "guts_parallel.h"
+
+mcmc_chain run_adaptive_metropolis(
+    box_posterior& posterior,
+    const std::vector<double >& init,
+    const std::vector<double >& scale,
+    const adaptive_metropolis_settings& settings,
+    std::mt19937_64& rng,
+    surrogate_posterior* surrogate
+) {
+  const std::size_t d = init.size();
+  std::vector<double > S;
+  if (!cholesky(scale, d, S)) {
+    throw std::invalid_argument("Proposal covariance 'scale' must be positive definite.");
+  }
+  std::normal_distribution<double > rnorm(0.0, 1.0);
+  std::uniform_real_distribution<double > runif(0.0, 1.0);
+
+  mcmc_chain chain(settings.n, d);
+  std::vector<double > x(init);
+  double lp = posterior(x);
+  if (!std::isfinite(lp)) {
+    throw std::domain_error("The log posterior must be finite at the initial parameter values.");
+  }
+
+  std::vector<double > U(d);
+  std::vector<double > prop(d);
+  std::vector<double > S_new;
+  // surrogate log posterior at x (delayed acceptance)
+  double ls = std::numeric_limits<double >::quiet_NaN();
+  for (std::size_t i = 0; i < settings.n; ++i) {
+    for (auto& u : U) u = rnorm(rng);
+    const std::vector<double > SU = lower_triangular_product(S, U);
+    for (std::size_t j = 0; j < d; ++j) prop[j] = x[j] + SU[j];
+
+    const bool adapting = i < settings.adapt;
+    const double log_u = std::log(runif(rng));
+
+    if (surrogate && !adapting) {
+      if (std::isnan(ls)) ls = (*surrogate)(x);
+      // first stage: surrogate
+      bool stopped, fine_known;
+      double lp_prop;
+      const double ls_prop = (*surrogate)(
+        prop, settings.early_rejection ? ls + log_u : -std::numeric_limits<double >::infinity(),
+        stopped, fine_known, lp_prop
+      );
+      if (stopped) ++chain.rejected_early;
+      if (ls_prop - ls > log_u) {
+        // second stage: full resolution
+        const double log_u2 = std::log(runif(rng));
+        if (!fine_known) {
+          const double threshold = settings.early_rejection ?
+            lp + log_u2 + ls_prop - ls : -std::numeric_limits<double >::infinity();
+          if (posterior(prop, threshold, lp_prop)) ++chain.rejected_early;
+        }
+        if (lp_prop - lp - ls_prop + ls > log_u2) {
+          x = prop;
+          lp = lp_prop;
+          ls = ls_prop;
+          ++chain.accepted;
+        }
+      } else {
+        ++chain.screened;
+      }
+      chain.set_sample(i, x, lp);
+      continue;
+    }
+    // the adaptation needs the exact acceptance probability
+    const double threshold = (adapting || !settings.early_rejection) ?
+      -std::numeric_limits<double >::infinity() : lp + log_u;
+    double lp_prop;
+    if (posterior(prop, threshold, lp_prop)) ++chain.rejected_early;
+
+    const double log_alpha = lp_prop - lp;
+    if (log_alpha > log_u) {
+      x = prop;
+      lp = lp_prop;
+      ++chain.accepted;
+    }
+
+    if (adapting) {
+      const double alpha = std::isnan(log_alpha) ? 0.0 : std::exp(std::min(0.0, log_alpha));
+      const double eta = std::min(1.0, static_cast<double >(d) * std::pow(static_cast<double >(i + 1), -settings.gamma));
+      double U2 = 0.0;
+      for (auto u : U) U2 += u * u;
+      std::vector<double > M = outer_product_of_factor(S, d);
+      const double w = eta * (alpha - settings.acc_rate) / U2;
+      for (std::size_t k = 0; k < d; ++k) {
+        for (std::size_t j = 0; j < d; ++j) M[j + k*d] += w * SU[j] * SU[k];
+      }
+      // keep the previous proposal if the update is not positive definite
+      if (cholesky(M, d, S_new)) S.swap(S_new);
+    }
+    chain.set_sample(i, x, lp);
+  }
+  chain.cov_jump = outer_product_of_factor(S, d);
+  return chain;
+}
+
+std::vector<mcmc_chain > run_adaptive_metropolis_chains(
+    const std::vector<guts_native_data >& data,
+    const parameter_bounds& bounds,
+    const std::vector<std::vector<double > >& inits,
+    const std::vector<double >& scale,
+    const adaptive_metropolis_settings& settings,
+    const std::uint32_t seed,
+    const std::size_t n_threads,
+    const std::vector<guts_native_data >& coarse_data
+) {
+  std::vector<mcmc_chain > chains(inits.size(), mcmc_chain(0, 0));
+  parallel_for(inits.size(), n_threads, [&](const std::size_t c) {
+    std::unique_ptr<guts_evaluator > evaluator = make_guts_evaluator(data);
+    box_posterior posterior(*evaluator, bounds);
+    std::mt19937_64 rng = make_stream_rng(seed, static_cast<std::uint32_t >(c));
+    if (coarse_data.empty()) {
+      chains[c] = run_adaptive_metropolis(posterior, inits[c], scale, settings, rng);
+    } else {
+      // delayed acceptance: surrogate on the same data with coarser discretization
+      std::unique_ptr<guts_evaluator > coarse_evaluator = make_guts_evaluator(coarse_data);
+      box_posterior coarse_posterior(*coarse_evaluator, bounds);
+      surrogate_posterior surrogate(coarse_posterior, posterior, bounds);
+      chains[c] = run_adaptive_metropolis(posterior, inits[c], scale, settings, rng, &surrogate);
+    }
+  });
+  return chains;
+}
+
+ensemble_chain run_stretch_move(
+    const std::vector<guts_native_data >& data,
+    const parameter_bounds& bounds,
+    const std::vector<std::vector<double > >& inits,
+    const ensemble_settings& settings,
+    const std::uint32_t seed,
+    const std::size_t n_threads
+) {
+  const std::size_t n_walkers = inits.size();
+  if (n_walkers < 2 || n_walkers % 2 != 0) {
+    throw std::invalid_argument("The number of walkers must be even.");
+  }
+  const std::size_t d = inits.front().size();
+  const std::size_t half = n_walkers / 2;
+  const double a = settings.a;
+  ensemble_chain chain(settings.n, n_walkers, d);
+
+  // one evaluator (projector workspace) per walker, reused in all iterations
+  std::vector<std::unique_ptr<guts_evaluator > > evaluators(n_walkers);
+  std::vector<std::vector<double > > X(inits);
+  std::vector<double > lp(n_walkers);
+  parallel_for(n_walkers, n_threads, [&](const std::size_t k) {
+    evaluators[k] = make_guts_evaluator(data);
+    box_posterior posterior(*evaluators[k], bounds);
+    lp[k] = posterior(X[k]);
+  });
+  for (auto l : lp) {
+    if (!std::isfinite(l)) {
+      throw std::domain_error("The log posterior must be finite at the initial parameter values of all walkers.");
+    }
+  }
+
+  std::mt19937_64 rng = make_stream_rng(seed, 0);
+  std::uniform_real_distribution<double > runif(0.0, 1.0);
+  std::uniform_int_distribution<std::size_t > rpartner(0, half - 1);
+  std::vector<std::vector<double > > Y(half, std::vector<double >(d));
+  std::vector<double > log_z(half);
+  std::vector<double > log_u(half);
+  std::vector<double > lp_prop(half);
+  std::vector<char > stopped(half);
+
+  for (std::size_t i = 0; i < settings.n; ++i) {
+    for (std::size_t h = 0; h < 2; ++h) {
+      const std::size_t first = h * half;
+      const std::size_t other = (1 - h) * half;
+      for (std::size_t m = 0; m < half; ++m) {
+        const std::size_t k = first + m;
+        const std::size_t j = other + rpartner(rng);
+        const double w = (a - 1.0) * runif(rng) + 1.0;
+        const double z = w * w / a;
+        log_z[m] = std::log(z);
+        log_u[m] = std::log(runif(rng));
+        for (std::size_t p = 0; p < d; ++p) Y[m][p] = X[j][p] + z * (X[k][p] - X[j][p]);
+      }
+      parallel_for(half, n_threads, [&](const std::size_t m) {
+        const std::size_t k = first + m;
+        const double threshold = settings.early_rejection ?
+          lp[k] + log_u[m] - static_cast<double >(d - 1) * log_z[m] :
+          -std::numeric_limits<double >::infinity();
+        box_posterior posterior(*evaluators[k], bounds);
+        stopped[m] = posterior(Y[m], threshold, lp_prop[m]);
+      });
+      for (std::size_t m = 0; m < half; ++m) {
+        const std::size_t k = first + m;
+        if (stopped[m]) ++chain.rejected_early;
+        if (static_cast<double >(d - 1) * log_z[m] + lp_prop[m] - lp[k] > log_u[m]) {
+          X[k] = Y[m];
+          lp[k] = lp_prop[m];
+          ++chain.accepted[k];
+        }
+      }
+    }
+    for (std::size_t k = 0; k < n_walkers; ++k) chain.set_sample(i, k, X[k], lp[k]);
+  }
+  return chain;
+}
@@ -0,0 +1,249 @@
+/**
+ * GUTS: Fast Calculation of the Likelihood of a Stochastic Survival Model.
+ * soeren.vogel@posteo.ch, carlo.albert@eawag.ch, alexander singer@rifcon.de, oliver.jakoby@rifcon.de, dirk.nickisch@rifcon.de
+ * License GPL-2
+ * 2026-10-19
+ */
+
+#ifndef GUTS_MCMC_H
+#define GUTS_MCMC_H
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+#include "guts_native.h"
+
+/**
+ * \brief Box constraints of parameters (uniform prior)
+ */
+struct parameter_bounds {
+  std::vector<double > lower;
+  std::vector<double > upper;
+  inline bool contains(const std::vector<double > & par) const {
+    for (std::size_t i = 0; i < par.size(); ++i) {
+      if (!std::isfinite(par[i]) || par[i] < lower[i] || par[i] > upper[i]) return false;
+    }
+    return true;
+  }
+};
+
+/**
+ * \brief Log posterior of GUTS parameters with a uniform prior on a box
+ * \details The constant of the uniform prior is omitted, i.e. the log posterior
+ * equals the loglikelihood within bounds and -Inf outside.
+ * Numerical failures of projections are treated as impossible parameter values (-Inf).
+ */
+class box_posterior {
+public:
+  box_posterior(guts_evaluator& new_evaluator, const parameter_bounds& new_bounds) :
+    evaluator(new_evaluator), bounds(new_bounds) {}
+  /**
+   * \param[in] par parameters
+   * \param[in] lower_bound stop early if the log posterior cannot reach this bound
+   * \param[out] log_p log posterior; an upper bound below lower_bound if rejected early
+   * \returns true if the projection was stopped early
+   */
+  inline bool operator()(const std::vector<double >& par, const double lower_bound, double& log_p) {
+    if (!bounds.contains(par)) {
+      log_p = -std::numeric_limits<double >::infinity();
+      return false;
+    }
+    const guts_status status = evaluator.calc_loglikelihood(par, lower_bound, log_p);
+    if (status == guts_status::rejected_early) return true;
+    if (status != guts_status::ok || std::isnan(log_p)) log_p = -std::numeric_limits<double >::infinity();
+    return false;
+  }
+  inline double operator()(const std::vector<double >& par) {
+    double log_p;
+    (*this)(par, -std::numeric_limits<double >::infinity(), log_p);
+    return log_p;
+  }
+private:
+  guts_evaluator& evaluator;
+  const parameter_bounds& bounds;
+};
+
+/**
+ * \brief Surrogate log posterior from a coarse discretization (smaller M and N)
+ * \details Where the coarse log posterior is not finite but the parameters are within bounds,
+ * the surrogate falls back to the fine log posterior. Hence, the surrogate is positive
+ * wherever the posterior is, as required by delayed acceptance.
+ */
+class surrogate_posterior {
+public:
+  surrogate_posterior(box_posterior& new_coarse, box_posterior& new_fine, const parameter_bounds& new_bounds) :
+    coarse(new_coarse), fine(new_fine), bounds(new_bounds) {}
+  /**
+   * \param[in] par parameters
+   * \param[in] lower_bound stop the coarse projection early if it cannot reach this bound
+   * \param[out] stopped true if the coarse projection was stopped early
+   * \param[out] fine_known true if the fine log posterior was evaluated (lp_fine)
+   * \param[out] lp_fine fine log posterior, if fine_known
+   * \returns the surrogate log posterior
+   */
+  inline double operator()(const std::vector<double >& par, const double lower_bound, bool& stopped, bool& fine_known, double& lp_fine) {
+    double log_p;
+    stopped = coarse(par, lower_bound, log_p);
+    fine_known = false;
+    if (stopped || std::isfinite(log_p) || !bounds.contains(par)) return log_p;
+    lp_fine = fine(par);
+    fine_known = true;
+    return lp_fine;
+  }
+  inline double operator()(const std::vector<double >& par) {
+    bool stopped, fine_known;
+    double lp_fine;
+    return (*this)(par, -std::numeric_limits<double >::infinity(), stopped, fine_known, lp_fine);
+  }
+private:
+  box_posterior& coarse;
+  box_posterior& fine;
+  const parameter_bounds& bounds;
+};
+
+/**
+ * \brief Settings of the robust adaptive Metropolis sampler
+ * \details
+ *   - n: number of iterations
+ *   - adapt: number of initial iterations that adapt the proposal covariance
+ *   - acc_rate: target acceptance rate of the adaptation
+ *   - gamma: exponent of the decay of the adaptation step size, in (0.5, 1]
+ *   - early_rejection: after adaptation, stop projections that cannot reach the acceptance threshold
+ */
+struct adaptive_metropolis_settings {
+  std::size_t n;
+  std::size_t adapt;
+  double acc_rate;
+  double gamma;
+  bool early_rejection;
+};
+
+/**
+ * \brief Result of a Markov chain
+ * \details samples is a n x d matrix (column-major), cov_jump the final d x d proposal covariance.
+ * screened counts proposals rejected by the surrogate (delayed acceptance).
+ */
+struct mcmc_chain {
+  std::size_t n;
+  std::size_t d;
+  std::vector<double > samples;
+  std::vector<double > log_p;
+  std::vector<double > cov_jump;
+  std::size_t accepted;
+  std::size_t rejected_early;
+  std::size_t screened;
+  mcmc_chain(const std::size_t new_n, const std::size_t new_d) :
+    n(new_n), d(new_d), samples(new_n * new_d), log_p(new_n), cov_jump(new_d * new_d),
+    accepted(0), rejected_early(0), screened(0) {}
+  inline void set_sample(const std::size_t i, const std::vector<double >& par, const double lp) {
+    for (std::size_t j = 0; j < d; ++j) samples[i + j*n] = par[j];
+    log_p[i] = lp;
+  }
+};
+
+/**
+ * \brief Robust adaptive Metropolis sampler
+ * \details Gaussian random walk whose proposal covariance S S^T is adapted towards
+ * the target acceptance rate (Vihola 2012, Stat Comput 22:997-1008), as in adaptMCMC::MCMC:
+ * \f$ S S^T \leftarrow S (I + \eta_i (\alpha_i - acc\_rate) U U^T / |U|^2) S^T \f$
+ * with \f$ \eta_i = \min(1, d i^{-\gamma}) \f$.
+ *
+ * With a surrogate, iterations after adaptation use delayed acceptance (Christen & Fox 2005,
+ * J Comput Graph Stat 14:795-810): a proposal y is first accepted with
+ * \f$ \alpha_1 = \min(1, \tilde\pi(y) / \tilde\pi(x)) \f$ by the cheap surrogate, and only then
+ * evaluated at full resolution and accepted with
+ * \f$ \alpha_2 = \min(1, \pi(y) \tilde\pi(x) / (\pi(x) \tilde\pi(y))) \f$,
+ * which keeps the posterior invariant. Adaptation always uses the full posterior.
+ * \param[in] posterior log posterior
+ * \param[in] init initial parameters (finite log posterior)
+ * \param[in] scale initial proposal covariance (d x d)
+ * \param[in] settings see adaptive_metropolis_settings
+ * \param[in,out] rng random number engine
+ * \param[in] surrogate surrogate of the log posterior for delayed acceptance (nullptr: none)
+ * \throws std::invalid_argument if scale is not positive definite
+ * \throws std::domain_error if the log posterior is not finite at init
+ */
+mcmc_chain run_adaptive_metropolis(
+    box_posterior& posterior,
+    const std::vector<double >& init,
+    const std::vector<double >& scale,
+    const adaptive_metropolis_settings& settings,
+    std::mt19937_64& rng,
+    surrogate_posterior* surrogate = nullptr
+);
+
+/**
+ * \brief Run independent chains of the robust adaptive Metropolis sampler in parallel
+ * \details Each chain uses its own evaluator of the data and random number stream (seed, chain index).
+ * \param[in] inits initial parameters of each chain
+ * \param[in] coarse_data the data with coarse discretization for delayed acceptance (empty: none)
+ */
+std::vector<mcmc_chain > run_adaptive_metropolis_chains(
+    const std::vector<guts_native_data >& data,
+    const parameter_bounds& bounds,
+    const std::vector<std::vector<double > >& inits,
+    const std::vector<double >& scale,
+    const adaptive_metropolis_settings& settings,
+    const std::uint32_t seed,
+    const std::size_t n_threads,
+    const std::vector<guts_native_data >& coarse_data = std::vector<guts_native_data >()
+);
+
+/**
+ * \brief Settings of the affine-invariant ensemble sampler
+ * \details
+ *   - n: number of iterations (each walker moves once per iteration)
+ *   - a: scale of the stretch move (> 1)
+ *   - early_rejection: stop projections that cannot reach the acceptance threshold
+ */
+struct ensemble_settings {
+  std::size_t n;
+  double a;
+  bool early_rejection;
+};
+
+/**
+ * \brief Result of an ensemble sampler
+ * \details samples is a n x n_walkers x d array and log_p a n x n_walkers matrix (column-major).
+ */
+struct ensemble_chain {
+  std::size_t n;
+  std::size_t n_walkers;
+  std::size_t d;
+  std::vector<double > samples;
+  std::vector<double > log_p;
+  std::vector<std::size_t > accepted;
+  std::size_t rejected_early;
+  ensemble_chain(const std::size_t new_n, const std::size_t new_n_walkers, const std::size_t new_d) :
+    n(new_n), n_walkers(new_n_walkers), d(new_d),
+    samples(new_n * new_n_walkers * new_d), log_p(new_n * new_n_walkers),
+    accepted(new_n_walkers, 0), rejected_early(0) {}
+  inline void set_sample(const std::size_t i, const std::size_t w, const std::vector<double >& par, const double lp) {
+    for (std::size_t j = 0; j < d; ++j) samples[i + n * (w + n_walkers * j)] = par[j];
+    log_p[i + n * w] = lp;
+  }
+};
+
+/**
+ * \brief Affine-invariant ensemble sampler with parallel stretch moves
+ * \details Walkers are split into two halves (Goodman & Weare 2010; Foreman-Mackey et al. 2013).
+ * Each walker \f$ X_k \f$ of one half moves to \f$ Y = X_j + z (X_k - X_j) \f$ with a random walker
+ * \f$ X_j \f$ of the other half and \f$ z \sim g(z) \propto 1/\sqrt{z} \f$ on \f$ [1/a, a] \f$,
+ * and is accepted with probability \f$ \min(1, z^{d-1} p(Y) / p(X_k)) \f$.
+ * Proposals of a half are evaluated in parallel; each walker keeps its own evaluator.
+ * Random numbers are drawn in the calling thread, such that results do not depend on n_threads.
+ * \param[in] inits initial parameters of the walkers (even number, finite log posterior)
+ * \throws std::domain_error if the log posterior of a walker is not finite at its initial parameters
+ */
+ensemble_chain run_stretch_move(
+    const std::vector<guts_native_data >& data,
+    const parameter_bounds& bounds,
+    const std::vector<std::vector<double > >& inits,
+    const ensemble_settings& settings,
+    const std::uint32_t seed,
+    const std::size_t n_threads
+);
+
+#endif //GUTS_MCMC_H
@@ -0,0 +1,158 @@
+/**
+ * GUTS: Fast Calculation of the Likelihood of a Stochastic Survival Model.
+ * soeren.vogel@posteo.ch, carlo.albert@eawag.ch, alexander singer@rifcon.de, oliver.jakoby@rifcon.de, dirk.nickisch@rifcon.de
+ * License GPL-2
+ * 2026-10-19
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "guts_native.h"
+
+typedef std::vector<double > nvec;
+typedef std::vector<float > nvec_single;
+///dual numbers of the parameters of the SD model and of the proper model with distribution delta (hb, kd, kk, z)
+typedef dual<4 > SD_dual;
+typedef std::vector<SD_dual > SD_dual_vec;
+///dual numbers of the parameters of the proper model with a parametric threshold distribution (hb, kd, kk, and two of the distribution)
+typedef dual<5 > proper_dual;
+typedef std::vector<proper_dual > proper_dual_vec;
+
+template<typename TD_mod >
+using native_projector = guts_projector<guts_RED<nvec, nvec, TD_mod, nvec >, nvec, nvec >;
+template<typename TD_mod, typename tdual_vec >
+using native_dual_projector = guts_projector<guts_RED<nvec, nvec, TD_mod, tdual_vec >, nvec, tdual_vec >;
+template<typename TD_mod >
+using native_fast_projector = guts_projector_fastIT<guts_RED<nvec, nvec, TD_mod, nvec >, nvec, nvec >;
+
+typedef external_data<nvec, nvec, true, true > native_dat_timediscrete_thresholddistdiscrete;
+typedef external_data<nvec, nvec, true, false > native_dat_timediscrete;
+typedef external_data<nvec, nvec, false, false > native_dat;
+
+std::size_t guts_parameter_size(const TD_type model, const dist_type dist) {
+  switch (model) {
+  case TD_type::PROPER :
+    switch (dist) {
+    case dist_type::LOGLOGISTIC :
+    case dist_type::LOGNORMAL : return 5;
+    case dist_type::DELTA : return 4;
+    case dist_type::EXTERNAL : return 3;
+    }
+    break;
+  case TD_type::IT :
+    switch (dist) {
+    case dist_type::LOGLOGISTIC :
+    case dist_type::LOGNORMAL : return 4;
+    case dist_type::EXTERNAL : return 2;
+    default : break;
+    }
+    break;
+  case TD_type::SD : return 4;
+  }
+  throw std::invalid_argument("Unknown combination of model and threshold distribution.");
+}
+
+std::vector<guts_native_data > coarsen_discretization(const std::vector<guts_native_data >& data, const double factor) {
+  if (!(factor >= 1.0)) throw std::invalid_argument("The coarsening factor must be >= 1.");
+  std::vector<guts_native_data > coarse(data);
+  for (auto& d : coarse) {
+    if (d.M > 0) d.M = std::max<std::size_t >(2, static_cast<std::size_t >(std::ceil(static_cast<double >(d.M) / factor)));
+    if (d.N > 0) d.N = std::max<std::size_t >(3, static_cast<std::size_t >(std::ceil(static_cast<double >(d.N) / factor)));
+  }
+  return coarse;
+}
+
+template<typename tProjector, typename tData >
+std::unique_ptr<guts_evaluator > make_projector_evaluator(const tData& dat, const guts_native_data& data) {
+  return std::unique_ptr<guts_evaluator >(new guts_projector_evaluator<tProjector >(dat, data));
+}
+
+template<typename tProjector, typename tDualProjector, std::size_t n, typename tData >
+std::unique_ptr<guts_evaluator > make_dual_projector_evaluator(const tData& dat, const guts_native_data& data) {
+  return std::unique_ptr<guts_evaluator >(new guts_dual_projector_evaluator<tProjector, tDualProjector, n >(dat, data));
+}
+
+std::unique_ptr<guts_evaluator > make_guts_evaluator(const guts_native_data& data) {
+  switch (data.model) {
+  case TD_type::IT : {
+    native_dat dat;
+    dat.set_data_unchecked(data.Ct, data.C, data.yt, data.SVR);
+    switch (data.dist) {
+    case dist_type::LOGLOGISTIC :
+      return make_projector_evaluator<native_fast_projector<TD_IT_loglogistic > >(dat, data);
+    case dist_type::LOGNORMAL :
+      return make_projector_evaluator<native_fast_projector<TD_IT_lognormal > >(dat, data);
+    case dist_type::EXTERNAL :
+      return make_projector_evaluator<native_fast_projector<TD<random_sample<nvec >, 'I' > > >(dat, data);
+    default :
+      break;
+    }
+    break;
+  }
+  case TD_type::SD : {
+    native_dat_timediscrete dat;
+    dat.set_data_unchecked(data.Ct, data.C, data.yt, data.M, data.SVR);
+    return make_dual_projector_evaluator<
+      native_projector<TD_SD >, native_dual_projector<TD_SD_scalar<SD_dual >, SD_dual_vec >, 4
+    >(dat, data);
+  }
+  case TD_type::PROPER : {
+    switch (data.dist) {
+    case dist_type::LOGLOGISTIC : {
+      native_dat_timediscrete_thresholddistdiscrete dat;
+      dat.set_data_unchecked(data.Ct, data.C, data.yt, data.M, data.N, data.SVR);
+      if (data.quadrature) {
+        return make_dual_projector_evaluator<
+          native_projector<TD_proper_quad_loglogistic >,
+          native_dual_projector<TD_proper_quad_loglogistic_scalar<proper_dual >, proper_dual_vec >, 5
+        >(dat, data);
+      }
+      return make_dual_projector_evaluator<
+        native_projector<TD_proper_loglogistic >,
+        native_dual_projector<TD_proper_loglogistic_scalar<proper_dual >, proper_dual_vec >, 5
+      >(dat, data);
+    }
+    case dist_type::LOGNORMAL : {
+      native_dat_timediscrete_thresholddistdiscrete dat;
+      dat.set_data_unchecked(data.Ct, data.C, data.yt, data.M, data.N, data.SVR);
+      if (data.quadrature) {
+        return make_dual_projector_evaluator<
+          native_projector<TD_proper_quad_lognormal >,
+          native_dual_projector<TD_proper_quad_lognormal_scalar<proper_dual >, proper_dual_vec >, 5
+        >(dat, data);
+      }
+      return make_dual_projector_evaluator<
+        native_projector<TD_proper_lognormal >,
+        native_dual_projector<TD_proper_lognormal_scalar<proper_dual >, proper_dual_vec >, 5
+      >(dat, data);
+    }
+    case dist_type::DELTA : {
+      native_dat_timediscrete dat;
+      dat.set_data_unchecked(data.Ct, data.C, data.yt, data.M, data.SVR);
+      return make_dual_projector_evaluator<
+        native_projector<TD_proper_delta >,
+        native_dual_projector<TD_proper_delta_scalar<SD_dual >, SD_dual_vec >, 4
+      >(dat, data);
+    }
+    case dist_type::EXTERNAL : {
+      native_dat_timediscrete dat;
+      dat.set_data_unchecked(data.Ct, data.C, data.yt, data.M, data.SVR);
+      if (data.single_precision) {
+        return make_projector_evaluator<native_projector<TD<random_sample<nvec_single >, 'P' > > >(dat, data);
+      }
+      return make_projector_evaluator<native_projector<TD<random_sample<nvec >, 'P' > > >(dat, data);
+    }
+    }
+    break;
+  }
+  }
+  throw std::invalid_argument("Unknown combination of model and threshold distribution.");
+}
+
+std::unique_ptr<guts_evaluator > make_guts_evaluator(const std::vector<guts_native_data >& data) {
+  if (data.size() == 1) return make_guts_evaluator(data.front());
+  std::unique_ptr<guts_joint_evaluator > joint(new guts_joint_evaluator());
+  for (const auto& d : data) joint->add(make_guts_evaluator(d));
+  return std::unique_ptr<guts_evaluator >(std::move(joint));
+}
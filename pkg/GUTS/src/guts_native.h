@@ -0,0 +1,311 @@
+/**
+ * GUTS: Fast Calculation of the Likelihood of a Stochastic Survival Model.
+ * soeren.vogel@posteo.ch, carlo.albert@eawag.ch, alexander singer@rifcon.de, oliver.jakoby@rifcon.de, dirk.nickisch@rifcon.de
+ * License GPL-2
+ * 2026-10-19
+ */
+
+#ifndef GUTS_NATIVE_H
+#define GUTS_NATIVE_H
+
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include <GUTS/GUTS_RED.h>
+#include <GUTS/guts_dual.h>
+#include <GUTS/external_data.h>
+#include <GUTS/guts_status.h>
+
+/**
+ * \brief Model types (reflected by attribute TD_type of GUTS objects)
+ */
+enum TD_type {
+  PROPER = 0,
+  IT = 1,
+  SD = 2
+};
+
+/**
+ * \brief Threshold distributions (reflected by attribute dist_type of GUTS objects)
+ */
+enum dist_type {
+  LOGLOGISTIC = 0,
+  LOGNORMAL = 1,
+  DELTA = 2,
+  EXTERNAL = 3
+};
+
+/**
+ * \brief Copy of a GUTS object that does not depend on R
+ * \details Evaluators hold their own projectors on this data, such that
+ * samplers and optimizers can evaluate parameters in worker threads.
+ */
+struct guts_native_data {
+  std::vector<double > C;
+  std::vector<double > Ct;
+  std::vector<double > yt;
+  std::vector<int > y;
+  std::size_t M;
+  std::size_t N;
+  double SVR;
+  TD_type model;
+  dist_type dist;
+  bool log_survival;
+  ///store threshold bins in single precision (model = PROPER, dist = EXTERNAL only, see proper_precision)
+  bool single_precision;
+  ///thresholds at Gauss quadrature nodes (model = PROPER, dist = LOGNORMAL or LOGLOGISTIC only, see quad_lognormal)
+  bool quadrature;
+  ///integrate the hazard with the trapezoidal rule (model = SD or PROPER, see guts_projector_base::set_trapezoid)
+  bool trapezoid;
+  ///sorted sample of thresholds (dist = EXTERNAL only)
+  std::vector<double > z_dist;
+};
+
+/**
+ * \brief Copy of data sets with coarser discretization
+ * \details M and N are divided by factor (at least 2 time steps and 3 threshold bins).
+ * Models without time discretization (IT) are copied unchanged.
+ */
+std::vector<guts_native_data > coarsen_discretization(const std::vector<guts_native_data >& data, const double factor);
+
+/**
+ * \returns the number of parameters of a GUTS model (without external threshold sample)
+ */
+std::size_t guts_parameter_size(const TD_type model, const dist_type dist);
+
+/**
+ * \brief Parameters of a projector from parameters as used by guts_calc_loglikelihood
+ * \details Inserts the unused killing rate of parametric IT models and appends
+ * the external threshold sample (see guts_engine).
+ * \param[out] full_par parameters of the projector
+ */
+inline void map_guts_parameters(
+    const guts_native_data& data,
+    const std::vector<double >& par,
+    std::vector<double >& full_par
+) {
+  if (data.model == TD_type::IT && data.dist != dist_type::EXTERNAL) {
+    full_par.assign({par.at(0), par.at(1), std::numeric_limits<double >::quiet_NaN(), par.at(2), par.at(3)});
+  } else {
+    full_par.assign(par.begin(), par.end());
+    full_par.insert(full_par.end(), data.z_dist.begin(), data.z_dist.end());
+  }
+}
+
+/**
+ * \brief Loglikelihood of GUTS parameters
+ * \details An evaluator owns its projector workspace and is not thread-safe.
+ * Use one evaluator per thread.
+ */
+class guts_evaluator {
+public:
+  virtual ~guts_evaluator() {}
+  /**
+   * \param[in] par parameters as used by guts_calc_loglikelihood
+   * \param[in] lower_bound stop early if the loglikelihood cannot reach this bound (-Inf: never)
+   * \param[out] LL loglikelihood; -Inf on failure; an upper bound below lower_bound if rejected early
+   * \returns guts_status::ok, guts_status::rejected_early or the reason of a failure
+   */
+  virtual guts_status calc_loglikelihood(
+      const std::vector<double >& par,
+      const double lower_bound,
+      double& LL
+  ) = 0;
+  inline double calc_loglikelihood(const std::vector<double >& par) {
+    double LL;
+    calc_loglikelihood(par, -std::numeric_limits<double >::infinity(), LL);
+    return LL;
+  }
+  /**
+   * \returns true if calc_loglikelihood_gradient() is available
+   */
+  virtual bool has_gradient() const {return false;}
+  /**
+   * \brief Loglikelihood and its exact gradient by forward-mode automatic differentiation
+   * \param[in] par parameters as used by guts_calc_loglikelihood
+   * \param[out] LL loglikelihood; -Inf on failure
+   * \param[out] gradient derivatives of LL with respect to par; NaN on failure
+   * \returns guts_status::ok or the reason of a failure
+   * \throws std::logic_error if the model has no gradient (see has_gradient())
+   */
+  virtual guts_status calc_loglikelihood_gradient(
+      const std::vector<double >&,
+      double&,
+      std::vector<double >&
+  ) {
+    throw std::logic_error("Exact gradients are not available for this model.");
+  }
+  /**
+   * \brief Survival probabilities at the survival times yt, as guts_calc_survivalprobs
+   * \param[in] par parameters as used by guts_calc_loglikelihood
+   * \param[out] p survival at each survival time; NaN on failure
+   * \returns guts_status::ok or the reason of a failure
+   * \throws std::logic_error for evaluators of several data sets
+   */
+  virtual guts_status calc_survival(
+      const std::vector<double >&,
+      std::vector<double >&
+  ) {
+    throw std::logic_error("Survival projections are only available for single data sets.");
+  }
+};
+
+/**
+ * \brief Evaluator of a single data set
+ * \tparam tProjector projector on std::vector
+ */
+template<typename tProjector >
+class guts_projector_evaluator : public guts_evaluator {
+public:
+  template<typename tData >
+  guts_projector_evaluator(const tData& data, const guts_native_data& native_data) :
+    y(native_data.y),
+    data_settings(native_data)
+  {
+    GUTS_INSTRUMENT_SCOPE(setup);
+    proj.initialize(data);
+    proj.set_log_survival(native_data.log_survival);
+    proj.set_trapezoid(native_data.trapezoid);
+  }
+  guts_status calc_loglikelihood(
+      const std::vector<double >& par,
+      const double lower_bound,
+      double& LL
+  ) override {
+    map_guts_parameters(data_settings, par, full_par);
+    bool rejected;
+    const guts_status status = try_project_loglikelihood(proj, full_par, y, lower_bound, LL, rejected);
+    return (status == guts_status::ok && rejected) ? guts_status::rejected_early : status;
+  }
+  guts_status calc_survival(
+      const std::vector<double >& par,
+      std::vector<double >& p
+  ) override {
+    map_guts_parameters(data_settings, par, full_par);
+    const guts_status status = try_project(proj, full_par);
+    if (status == guts_status::ok) {
+      proj.get_survival_projection(p);
+    } else {
+      p.assign(y.size(), std::numeric_limits<double >::quiet_NaN());
+    }
+    return status;
+  }
+protected:
+  const std::vector<int > y;
+private:
+  tProjector proj;
+  // model, distribution and external threshold sample
+  const guts_native_data data_settings;
+  std::vector<double > full_par;
+};
+
+/**
+ * \brief Evaluator of a single data set with exact gradients
+ * \details A second projector propagates dual numbers through the model, which yields
+ * the loglikelihood and its derivatives with respect to all n parameters in one projection.
+ * \tparam tProjector projector on std::vector<double >
+ * \tparam tDualProjector projector of the same model on std::vector<dual<n > >
+ * \tparam n number of parameters
+ */
+template<typename tProjector, typename tDualProjector, std::size_t n >
+class guts_dual_projector_evaluator : public guts_projector_evaluator<tProjector > {
+public:
+  template<typename tData >
+  guts_dual_projector_evaluator(const tData& data, const guts_native_data& native_data) :
+    guts_projector_evaluator<tProjector >(data, native_data),
+    dual_par(n)
+  {
+    dual_proj.initialize(data);
+    dual_proj.set_log_survival(native_data.log_survival);
+    dual_proj.set_trapezoid(native_data.trapezoid);
+  }
+  bool has_gradient() const override {return true;}
+  guts_status calc_loglikelihood_gradient(
+      const std::vector<double >& par,
+      double& LL,
+      std::vector<double >& gradient
+  ) override {
+    if (par.size() != n) throw std::invalid_argument("Wrong number of parameters.");
+    for (std::size_t i = 0; i < n; ++i) dual_par[i] = dual<n >(par[i], i);
+    dual<n > dual_LL;
+    bool rejected;
+    const guts_status status = try_project_loglikelihood(
+      dual_proj, dual_par, this->y, -std::numeric_limits<double >::infinity(), dual_LL, rejected
+    );
+    LL = dual_LL.v;
+    gradient.assign(dual_LL.d.begin(), dual_LL.d.end());
+    if (status != guts_status::ok || !std::isfinite(LL)) {
+      LL = -std::numeric_limits<double >::infinity();
+      gradient.assign(n, std::numeric_limits<double >::quiet_NaN());
+    }
+    return status;
+  }
+private:
+  tDualProjector dual_proj;
+  std::vector<dual<n > > dual_par;
+};
+
+/**
+ * \brief Joint loglikelihood of several data sets with common parameters
+ * \details The loglikelihood of each data set is non-positive. Hence, a data set
+ * is evaluated with the lower bound reduced by the loglikelihood of the previous ones.
+ */
+class guts_joint_evaluator : public guts_evaluator {
+public:
+  void add(std::unique_ptr<guts_evaluator > evaluator) {
+    parts.push_back(std::move(evaluator));
+  }
+  guts_status calc_loglikelihood(
+      const std::vector<double >& par,
+      const double lower_bound,
+      double& LL
+  ) override {
+    LL = 0.0;
+    double LL_part;
+    for (auto& part : parts) {
+      const guts_status status = part->calc_loglikelihood(par, lower_bound - LL, LL_part);
+      LL += LL_part;
+      if (status != guts_status::ok) return status;
+    }
+    return guts_status::ok;
+  }
+  bool has_gradient() const override {
+    for (const auto& part : parts) {
+      if (!part->has_gradient()) return false;
+    }
+    return !parts.empty();
+  }
+  guts_status calc_loglikelihood_gradient(
+      const std::vector<double >& par,
+      double& LL,
+      std::vector<double >& gradient
+  ) override {
+    LL = 0.0;
+    gradient.assign(par.size(), 0.0);
+    double LL_part;
+    std::vector<double > gradient_part;
+    for (auto& part : parts) {
+      const guts_status status = part->calc_loglikelihood_gradient(par, LL_part, gradient_part);
+      LL += LL_part;
+      for (std::size_t i = 0; i < gradient.size(); ++i) gradient[i] += gradient_part[i];
+      if (status != guts_status::ok) return status;
+    }
+    return guts_status::ok;
+  }
+private:
+  std::vector<std::unique_ptr<guts_evaluator > > parts;
+};
+
+/**
+ * \brief Create an evaluator of a data set
+ * \throws std::invalid_argument for unknown model and distribution combinations
+ */
+std::unique_ptr<guts_evaluator > make_guts_evaluator(const guts_native_data& data);
+
+/**
+ * \brief Create an evaluator of the joint loglikelihood of several data sets
+ */
+std::unique_ptr<guts_evaluator > make_guts_evaluator(const std::vector<guts_native_data >& data);
+
+#endif //GUTS_NATIVE_H
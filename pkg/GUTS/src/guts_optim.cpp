@@ -0,0 +1,516 @@
+/**
+ * GUTS: Fast Calculation of the Likelihood of a Stochastic Survival Model.
+ * soeren.vogel@posteo.ch, carlo.albert@eawag.ch, alexander singer@rifcon.de, oliver.jakoby@rifcon.de, dirk.nickisch@rifcon.de
+ * License GPL-2
+ * 2026-10-19
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include "guts_optim.h"
+#include "guts_linalg.h"
+#include "guts_parallel.h"
+
+parallel_objective::parallel_objective(
+    const std::vector<guts_native_data >& data,
+    const parameter_bounds& new_bounds,
+    const std::size_t new_n_threads,
+    const double new_fd_step
+) :
+  bounds(new_bounds),
+  n_threads(std::max<std::size_t >(1, std::min(new_n_threads, 2 * new_bounds.lower.size()))),
+  fd_step(new_fd_step),
+  evaluators(n_threads),
+  exact_gradient(false),
+  n_projection(0)
+{
+  for (auto& evaluator : evaluators) evaluator = make_guts_evaluator(data);
+  exact_gradient = evaluators.front()->has_gradient();
+}
+
+double parallel_objective::evaluate(guts_evaluator& evaluator, const std::vector<double >& par, const double upper_bound) {
+  double LL;
+  const guts_status status = evaluator.calc_loglikelihood(par, -upper_bound, LL);
+  if (status != guts_status::ok || std::isnan(LL)) return std::numeric_limits<double >::infinity();
+  return -LL;
+}
+
+double parallel_objective::value(const std::vector<double >& par, const double upper_bound) {
+  ++n_projection;
+  return evaluate(*evaluators.front(), par, upper_bound);
+}
+
+double parallel_objective::value(const std::vector<double >& par) {
+  return value(par, std::numeric_limits<double >::infinity());
+}
+
+bool parallel_objective::evaluate_gradient(const std::vector<double >& par, std::vector<double >& g) {
+  ++n_projection;
+  double LL;
+  const guts_status status = evaluators.front()->calc_loglikelihood_gradient(par, LL, g);
+  if (status != guts_status::ok || !std::isfinite(LL)) return false;
+  for (auto& gi : g) {
+    if (!std::isfinite(gi)) return false;
+    gi = -gi;
+  }
+  return true;
+}
+
+std::vector<double > parallel_objective::gradient(const std::vector<double >& par, const double f) {
+  const std::size_t d = par.size();
+  std::vector<double > g_exact;
+  if (exact_gradient && evaluate_gradient(par, g_exact)) return g_exact;
+  // trial points x + h e_i (task 2i) and x - h e_i (task 2i + 1), within bounds
+  std::vector<std::vector<double > > points(2 * d, par);
+  std::vector<double > values(2 * d, f);
+  std::vector<char > at_par(2 * d, 0);
+  for (std::size_t i = 0; i < d; ++i) {
+    const double h = fd_step * (std::abs(par[i]) + fd_step);
+    points[2*i][i] = std::min(par[i] + h, bounds.upper[i]);
+    points[2*i + 1][i] = std::max(par[i] - h, bounds.lower[i]);
+    at_par[2*i] = points[2*i][i] == par[i];
+    at_par[2*i + 1] = points[2*i + 1][i] == par[i];
+  }
+  // task k always runs in thread k % n_threads, see parallel_for
+  parallel_for(2 * d, n_threads, [&](const std::size_t k) {
+    if (!at_par[k]) values[k] = evaluate(*evaluators[k % n_threads], points[k], std::numeric_limits<double >::infinity());
+  });
+  for (auto a : at_par) n_projection += a ? 0 : 1;
+
+  std::vector<double > g(d);
+  for (std::size_t i = 0; i < d; ++i) {
+    double xp = points[2*i][i], fp = values[2*i];
+    double xm = points[2*i + 1][i], fm = values[2*i + 1];
+    // one-sided if a trial point fails
+    if (!std::isfinite(fp)) {xp = par[i]; fp = f;}
+    if (!std::isfinite(fm)) {xm = par[i]; fm = f;}
+    g[i] = (xp > xm) ? (fp - fm) / (xp - xm) : 0.0;
+  }
+  return g;
+}
+
+std::vector<double > parallel_objective::hessian(const std::vector<double >& par, const double f) {
+  const std::size_t d = par.size();
+  std::vector<double > H(d * d);
+  for (std::size_t j = 0; j < d; ++j) {
+    const double h = fd_step * (std::abs(par[j]) + fd_step);
+    std::vector<double > xp(par), xm(par);
+    xp[j] = std::min(par[j] + h, bounds.upper[j]);
+    xm[j] = std::max(par[j] - h, bounds.lower[j]);
+    std::vector<double > gp, gm;
+    if (!exact_gradient || !evaluate_gradient(xp, gp)) gp = gradient(xp, (xp[j] == par[j]) ? f : value(xp));
+    if (!exact_gradient || !evaluate_gradient(xm, gm)) gm = gradient(xm, (xm[j] == par[j]) ? f : value(xm));
+    for (std::size_t i = 0; i < d; ++i) H[i + j*d] = (gp[i] - gm[i]) / (xp[j] - xm[j]);
+  }
+  for (std::size_t j = 0; j < d; ++j) {
+    for (std::size_t i = 0; i < j; ++i) {
+      const double s = 0.5 * (H[i + j*d] + H[j + i*d]);
+      H[i + j*d] = s;
+      H[j + i*d] = s;
+    }
+  }
+  return H;
+}
+
+namespace {
+
+std::vector<double > identity(const std::size_t d) {
+  std::vector<double > I(d * d, 0.0);
+  for (std::size_t i = 0; i < d; ++i) I[i + i*d] = 1.0;
+  return I;
+}
+
+std::vector<double > project(std::vector<double > x, const parameter_bounds& bounds) {
+  for (std::size_t i = 0; i < x.size(); ++i) x[i] = std::min(std::max(x[i], bounds.lower[i]), bounds.upper[i]);
+  return x;
+}
+
+// parameters at a bound with the gradient (of the objective) pointing outwards
+std::vector<char > active_set(const std::vector<double >& x, const std::vector<double >& g, const parameter_bounds& bounds) {
+  std::vector<char > active(x.size());
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    active[i] = (x[i] <= bounds.lower[i] && g[i] > 0.0) || (x[i] >= bounds.upper[i] && g[i] < 0.0);
+  }
+  return active;
+}
+
+// BFGS update of the inverse Hessian approximation B with step s and gradient change y (s'y > 0)
+void update_inverse_hessian(std::vector<double >& B, const std::vector<double >& s, const std::vector<double >& y) {
+  const std::size_t d = s.size();
+  double sy = 0.0;
+  for (std::size_t i = 0; i < d; ++i) sy += s[i] * y[i];
+  std::vector<double > By(d, 0.0);
+  for (std::size_t j = 0; j < d; ++j) {
+    for (std::size_t i = 0; i < d; ++i) By[i] += B[i + j*d] * y[j];
+  }
+  double yBy = 0.0;
+  for (std::size_t i = 0; i < d; ++i) yBy += y[i] * By[i];
+  const double c = (sy + yBy) / (sy * sy);
+  for (std::size_t j = 0; j < d; ++j) {
+    for (std::size_t i = 0; i < d; ++i) {
+      B[i + j*d] += c * s[i] * s[j] - (By[i] * s[j] + s[i] * By[j]) / sy;
+    }
+  }
+}
+
+} // namespace
+
+fit_result run_bounded_quasi_newton(
+    const std::vector<guts_native_data >& data,
+    const parameter_bounds& bounds,
+    const std::vector<double >& init,
+    const quasi_newton_settings& settings,
+    const std::size_t n_threads
+) {
+  const std::size_t d = init.size();
+  const double armijo = 1e-4;
+  const std::size_t max_backtrack = 40;
+  parallel_objective objective(data, bounds, n_threads, settings.fd_step);
+
+  fit_result result;
+  result.iterations = 0;
+  result.n_function = 1;
+  result.n_gradient = 1;
+  result.convergence = 1;
+  result.message = "maximum number of iterations reached";
+
+  std::vector<double > x = project(init, bounds);
+  double f = objective.value(x);
+  if (!std::isfinite(f)) {
+    throw std::domain_error("The loglikelihood must be finite at the initial parameter values.");
+  }
+  std::vector<double > g = objective.gradient(x, f);
+  std::vector<double > B = identity(d);
+  bool B_is_identity = true;
+
+  while (result.iterations < settings.max_iter) {
+    const std::vector<char > active = active_set(x, g, bounds);
+    double pg = 0.0;
+    for (std::size_t i = 0; i < d; ++i) {
+      if (!active[i]) pg = std::max(pg, std::abs(g[i]));
+    }
+    if (pg <= settings.pgtol) {
+      result.convergence = 0;
+      result.message = "projected gradient below pgtol";
+      break;
+    }
+    ++result.iterations;
+
+    // quasi-Newton direction of the free parameters
+    std::vector<double > p(d, 0.0);
+    double slope = 0.0;
+    for (std::size_t i = 0; i < d; ++i) {
+      if (active[i]) continue;
+      for (std::size_t j = 0; j < d; ++j) {
+        if (!active[j]) p[i] -= B[i + j*d] * g[j];
+      }
+      slope += p[i] * g[i];
+    }
+    if (!(slope < 0.0)) {
+      B = identity(d);
+      B_is_identity = true;
+      for (std::size_t i = 0; i < d; ++i) p[i] = active[i] ? 0.0 : -g[i];
+    }
+
+    // projected backtracking line search
+    double t = 1.0;
+    bool found = false;
+    std::vector<double > x_new;
+    double f_new = f;
+    for (std::size_t k = 0; k < max_backtrack; ++k, t *= 0.5) {
+      x_new = x;
+      for (std::size_t i = 0; i < d; ++i) x_new[i] += t * p[i];
+      x_new = project(x_new, bounds);
+      double decrease = 0.0;
+      for (std::size_t i = 0; i < d; ++i) decrease += g[i] * (x_new[i] - x[i]);
+      if (!(decrease < 0.0)) continue;
+      const double target = f + armijo * decrease;
+      f_new = objective.value(x_new, target);
+      ++result.n_function;
+      if (f_new <= target) {
+        found = true;
+        break;
+      }
+    }
+    if (!found) {
+      if (!B_is_identity) {
+        // retry along the projected steepest descent
+        B = identity(d);
+        B_is_identity = true;
+        continue;
+      }
+      result.convergence = 52;
+      result.message = "line search failed";
+      break;
+    }
+
+    const std::vector<double > g_new = objective.gradient(x_new, f_new);
+    ++result.n_gradient;
+    std::vector<double > s(d), y(d);
+    double sy = 0.0, ss = 0.0, yy = 0.0;
+    for (std::size_t i = 0; i < d; ++i) {
+      s[i] = x_new[i] - x[i];
+      y[i] = g_new[i] - g[i];
+      sy += s[i] * y[i];
+      ss += s[i] * s[i];
+      yy += y[i] * y[i];
+    }
+    // skip updates that would not keep B positive definite
+    if (sy > 1e-10 * std::sqrt(ss * yy)) {
+      if (B_is_identity) {
+        // initial scaling (Nocedal & Wright 2006, eq. 6.20)
+        for (auto& b : B) b *= sy / yy;
+        B_is_identity = false;
+      }
+      update_inverse_hessian(B, s, y);
+    }
+
+    const double reduction = f - f_new;
+    x = x_new;
+    g = g_new;
+    f = f_new;
+    if (reduction <= settings.factr * std::numeric_limits<double >::epsilon() * std::max(std::max(std::abs(f), std::abs(f + reduction)), 1.0)) {
+      result.convergence = 0;
+      result.message = "relative reduction of the objective below factr * epsilon";
+      break;
+    }
+  }
+
+  result.par = x;
+  result.LL = -f;
+  // gradient of the loglikelihood
+  result.gradient.resize(d);
+  for (std::size_t i = 0; i < d; ++i) result.gradient[i] = -g[i];
+  result.hessian.assign(d * d, std::numeric_limits<double >::quiet_NaN());
+  result.cov.assign(d * d, std::numeric_limits<double >::quiet_NaN());
+  if (settings.hessian) {
+    result.hessian = objective.hessian(x, f);
+    std::vector<double > L;
+    if (cholesky(result.hessian, d, L)) result.cov = cholesky_inverse(L, d);
+  }
+  result.n_projection = objective.get_n_projection();
+  return result;
+}
+
+namespace {
+
+// conditional estimates along one direction of a profile
+struct profile_walk {
+  std::vector<double > value;
+  std::vector<double > LL;
+  std::vector<std::vector<double > > par;
+  double bound;
+  std::size_t n_projection;
+};
+
+profile_walk walk_profile(
+    const std::vector<guts_native_data >& data,
+    const parameter_bounds& bounds,
+    const std::vector<double >& estimate,
+    const double LL_max,
+    const std::size_t j,
+    const double step,
+    const profile_settings& settings,
+    const std::size_t n_threads
+) {
+  const double threshold = LL_max - settings.LL_drop;
+  profile_walk walk;
+  walk.bound = std::numeric_limits<double >::quiet_NaN();
+  walk.n_projection = 0;
+  std::vector<double > x = estimate;
+  double v_previous = estimate[j];
+  double LL_previous = LL_max;
+  for (std::size_t s = 0; s < settings.max_steps; ++s) {
+    if (v_previous == (step > 0.0 ? bounds.upper[j] : bounds.lower[j])) {
+      walk.bound = v_previous;
+      break;
+    }
+    const double v = std::min(std::max(v_previous + step, bounds.lower[j]), bounds.upper[j]);
+    parameter_bounds conditional = bounds;
+    conditional.lower[j] = v;
+    conditional.upper[j] = v;
+    x[j] = v;
+    double LL = -std::numeric_limits<double >::infinity();
+    try {
+      const fit_result fit = run_bounded_quasi_newton(data, conditional, x, settings.fit, n_threads);
+      x = fit.par;
+      LL = fit.LL;
+      walk.n_projection += fit.n_projection;
+    } catch (const std::domain_error&) {
+      // loglikelihood not finite at the starting point
+      ++walk.n_projection;
+    }
+    walk.value.push_back(v);
+    walk.LL.push_back(LL);
+    walk.par.push_back(x);
+    if (LL < threshold) {
+      walk.bound = v_previous + (v - v_previous) * (LL_previous - threshold) / (LL_previous - LL);
+      break;
+    }
+    v_previous = v;
+    LL_previous = LL;
+  }
+  return walk;
+}
+
+} // namespace
+
+std::vector<profile_curve > run_profile_likelihood(
+    const std::vector<guts_native_data >& data,
+    const parameter_bounds& bounds,
+    const std::vector<double >& estimate,
+    const double LL_max,
+    const std::vector<std::size_t >& which,
+    const std::vector<double >& step,
+    const profile_settings& settings,
+    const std::size_t n_threads
+) {
+  const std::size_t d = estimate.size();
+  if (!bounds.contains(estimate)) throw std::invalid_argument("The estimate must be within bounds.");
+  for (std::size_t i = 0; i < which.size(); ++i) {
+    if (which[i] >= d) throw std::invalid_argument("Index of a profiled parameter out of range.");
+    if (!(step[i] > 0.0) || !std::isfinite(step[i])) throw std::invalid_argument("Profile steps must be positive.");
+  }
+  // walk 2i towards lower, walk 2i + 1 towards upper values of parameter which[i]
+  const std::size_t n_walks = 2 * which.size();
+  const std::size_t n_inner = std::max<std::size_t >(1, n_threads / std::max<std::size_t >(1, n_walks));
+  std::vector<profile_walk > walks(n_walks);
+  parallel_for(n_walks, n_threads, [&](const std::size_t w) {
+    const std::size_t i = w / 2;
+    walks[w] = walk_profile(data, bounds, estimate, LL_max, which[i], (w % 2 == 0) ? -step[i] : step[i], settings, n_inner);
+  });
+
+  std::vector<profile_curve > curves(which.size());
+  for (std::size_t i = 0; i < which.size(); ++i) {
+    const profile_walk& down = walks[2*i];
+    const profile_walk& up = walks[2*i + 1];
+    profile_curve& curve = curves[i];
+    curve.which = which[i];
+    curve.lower = down.bound;
+    curve.upper = up.bound;
+    curve.n_projection = down.n_projection + up.n_projection;
+    std::vector<const std::vector<double >* > points;
+    for (std::size_t k = down.value.size(); k > 0; --k) {
+      curve.value.push_back(down.value[k-1]);
+      curve.LL.push_back(down.LL[k-1]);
+      points.push_back(&down.par[k-1]);
+    }
+    curve.value.push_back(estimate[which[i]]);
+    curve.LL.push_back(LL_max);
+    points.push_back(&estimate);
+    for (std::size_t k = 0; k < up.value.size(); ++k) {
+      curve.value.push_back(up.value[k]);
+      curve.LL.push_back(up.LL[k]);
+      points.push_back(&up.par[k]);
+    }
+    const std::size_t n = points.size();
+    curve.par.resize(n * d);
+    for (std::size_t k = 0; k < n; ++k) {
+      for (std::size_t l = 0; l < d; ++l) curve.par[k + l*n] = (*points[k])[l];
+    }
+  }
+  return curves;
+}
+
+differential_evolution_result run_differential_evolution(
+    const std::vector<guts_native_data >& data,
+    const parameter_bounds& bounds,
+    const std::vector<double >& init,
+    const differential_evolution_settings& settings,
+    const std::uint32_t seed,
+    const std::size_t n_threads
+) {
+  const std::size_t d = bounds.lower.size();
+  const std::size_t n_pop = settings.n_pop;
+  if (n_pop < 4) throw std::invalid_argument("The population needs at least 4 members.");
+  for (std::size_t j = 0; j < d; ++j) {
+    if (!std::isfinite(bounds.lower[j]) || !std::isfinite(bounds.upper[j]) || bounds.lower[j] > bounds.upper[j]) {
+      throw std::invalid_argument("Differential evolution needs finite bounds with lower <= upper.");
+    }
+  }
+  const std::size_t T = std::max<std::size_t >(1, std::min(n_threads, n_pop));
+  std::vector<std::unique_ptr<guts_evaluator > > evaluators(T);
+  for (auto& evaluator : evaluators) evaluator = make_guts_evaluator(data);
+
+  differential_evolution_result result;
+  result.n_projection = 0;
+  result.rejected_early = 0;
+  result.convergence = 1;
+  result.message = "maximum number of generations reached";
+
+  std::mt19937_64 rng = make_stream_rng(seed, 0);
+  std::uniform_real_distribution<double > runif(0.0, 1.0);
+  std::uniform_int_distribution<std::size_t > rmember(0, n_pop - 1);
+  std::uniform_int_distribution<std::size_t > rcomponent(0, d - 1);
+
+  std::vector<std::vector<double > > X(n_pop, std::vector<double >(d));
+  for (std::size_t i = 0; i < n_pop; ++i) {
+    for (std::size_t j = 0; j < d; ++j) X[i][j] = bounds.lower[j] + runif(rng) * (bounds.upper[j] - bounds.lower[j]);
+  }
+  if (!init.empty()) X[0] = project(init, bounds);
+
+  // loglikelihood of members, task i runs in thread i % T (see parallel_for)
+  std::vector<double > LL(n_pop);
+  parallel_for(n_pop, T, [&](const std::size_t i) {
+    box_posterior posterior(*evaluators[i % T], bounds);
+    LL[i] = posterior(X[i]);
+  });
+  result.n_projection += n_pop;
+
+  std::vector<std::vector<double > > Y(n_pop, std::vector<double >(d));
+  std::vector<double > LL_trial(n_pop);
+  std::vector<char > stopped(n_pop);
+
+  std::size_t gen = 0;
+  while (gen < settings.max_gen) {
+    ++gen;
+    for (std::size_t i = 0; i < n_pop; ++i) {
+      std::size_t a, b, c;
+      do {a = rmember(rng);} while (a == i);
+      do {b = rmember(rng);} while (b == i || b == a);
+      do {c = rmember(rng);} while (c == i || c == a || c == b);
+      const std::size_t j_rand = rcomponent(rng);
+      for (std::size_t j = 0; j < d; ++j) {
+        const bool cross = runif(rng) < settings.CR || j == j_rand;
+        double y = cross ? X[a][j] + settings.F * (X[b][j] - X[c][j]) : X[i][j];
+        if (y < bounds.lower[j]) y = 0.5 * (X[i][j] + bounds.lower[j]);
+        if (y > bounds.upper[j]) y = 0.5 * (X[i][j] + bounds.upper[j]);
+        Y[i][j] = y;
+      }
+    }
+    parallel_for(n_pop, T, [&](const std::size_t i) {
+      box_posterior posterior(*evaluators[i % T], bounds);
+      const double lower_bound = std::isfinite(LL[i]) ? LL[i] : -std::numeric_limits<double >::infinity();
+      stopped[i] = posterior(Y[i], lower_bound, LL_trial[i]);
+    });
+    result.n_projection += n_pop;
+    for (std::size_t i = 0; i < n_pop; ++i) {
+      if (stopped[i]) ++result.rejected_early;
+      if (LL_trial[i] >= LL[i]) {
+        X[i] = Y[i];
+        LL[i] = LL_trial[i];
+      }
+    }
+    // converged if all members have (nearly) the same loglikelihood
+    const auto range = std::minmax_element(LL.begin(), LL.end());
+    const double best = *range.second;
+    if (std::isfinite(*range.first) && best - *range.first <= settings.reltol * (std::abs(best) + settings.reltol)) {
+      result.convergence = 0;
+      result.message = "loglikelihood of all members within reltol";
+      break;
+    }
+  }
+
+  const std::size_t i_best = static_cast<std::size_t >(std::max_element(LL.begin(), LL.end()) - LL.begin());
+  result.par = X[i_best];
+  result.LL = LL[i_best];
+  result.generations = gen;
+  result.population.resize(n_pop * d);
+  for (std::size_t i = 0; i < n_pop; ++i) {
+    for (std::size_t j = 0; j < d; ++j) result.population[i + j*n_pop] = X[i][j];
+  }
+  result.population_LL = LL;
+  return result;
+}
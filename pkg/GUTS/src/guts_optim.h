@@ -0,0 +1,233 @@
+/**
+ * GUTS: Fast Calculation of the Likelihood of a Stochastic Survival Model.
+ * soeren.vogel@posteo.ch, carlo.albert@eawag.ch, alexander singer@rifcon.de, oliver.jakoby@rifcon.de, dirk.nickisch@rifcon.de
+ * License GPL-2
+ * 2026-10-19
+ */
+
+#ifndef GUTS_OPTIM_H
+#define GUTS_OPTIM_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "guts_mcmc.h"
+#include "guts_native.h"
+
+/**
+ * \brief Settings of the bounded quasi-Newton optimizer
+ * \details
+ *   - max_iter: maximum number of iterations
+ *   - factr: stop if the relative reduction of the objective is below factr times the machine epsilon (as optim)
+ *   - pgtol: stop if the largest projected gradient component is at most pgtol
+ *   - fd_step: relative step of finite differences, h = fd_step (|x| + fd_step)
+ *   - hessian: calculate the Hessian at the optimum
+ */
+struct quasi_newton_settings {
+  std::size_t max_iter;
+  double factr;
+  double pgtol;
+  double fd_step;
+  bool hessian;
+};
+
+/**
+ * \brief Result of a maximum likelihood fit
+ * \details hessian is the d x d Hessian of the negative loglikelihood (column-major),
+ * cov its inverse (NaN if the Hessian is not positive definite or not calculated).
+ * convergence uses the codes of optim: 0 (converged), 1 (max_iter reached), 52 (line search failed).
+ */
+struct fit_result {
+  std::vector<double > par;
+  double LL;
+  std::vector<double > gradient;
+  std::vector<double > hessian;
+  std::vector<double > cov;
+  std::size_t iterations;
+  std::size_t n_function;
+  std::size_t n_gradient;
+  std::size_t n_projection;
+  int convergence;
+  std::string message;
+};
+
+/**
+ * \brief Negative loglikelihood with derivatives, evaluated in parallel
+ * \details Holds one evaluator per thread. Gradients are exact (automatic differentiation)
+ * if the model provides them (see guts_evaluator::has_gradient()). Otherwise, the 2d evaluations
+ * of a central difference gradient run in parallel; at bounds, differences become one-sided.
+ * Numerical failures of projections are +Inf.
+ */
+class parallel_objective {
+public:
+  parallel_objective(
+      const std::vector<guts_native_data >& data,
+      const parameter_bounds& new_bounds,
+      const std::size_t new_n_threads,
+      const double new_fd_step
+  );
+  /**
+   * \param[in] par parameters within bounds
+   * \param[in] upper_bound stop early if the objective is certainly above this bound (result: +Inf)
+   */
+  double value(const std::vector<double >& par, const double upper_bound);
+  double value(const std::vector<double >& par);
+  /**
+   * \param[in] par parameters within bounds
+   * \param[in] f objective at par
+   * \returns the gradient
+   */
+  std::vector<double > gradient(const std::vector<double >& par, const double f);
+  /**
+   * \returns the symmetric d x d Hessian from central differences of gradients
+   */
+  std::vector<double > hessian(const std::vector<double >& par, const double f);
+  std::size_t get_n_projection() const {return n_projection;}
+  bool has_exact_gradient() const {return exact_gradient;}
+private:
+  const parameter_bounds& bounds;
+  const std::size_t n_threads;
+  const double fd_step;
+  std::vector<std::unique_ptr<guts_evaluator > > evaluators;
+  bool exact_gradient;
+  std::size_t n_projection;
+  double evaluate(guts_evaluator& evaluator, const std::vector<double >& par, const double upper_bound);
+  // exact gradient; false if the projection fails
+  bool evaluate_gradient(const std::vector<double >& par, std::vector<double >& g);
+};
+
+/**
+ * \brief Maximize the joint loglikelihood of data sets within box constraints
+ * \details Projected quasi-Newton method: the BFGS approximation of the inverse Hessian
+ * determines the search direction of the free parameters, parameters at a bound with the
+ * gradient pointing outwards are fixed. Steps are projected onto the box and backtracked
+ * until the (projected) Armijo condition holds; trial points that cannot reach the Armijo
+ * condition are stopped early. Gradients are exact for the SD model and the proper model with a
+ * parametric threshold distribution (forward-mode automatic differentiation) and central
+ * finite differences evaluated in parallel otherwise.
+ * \param[in] init initial parameters (projected onto the bounds)
+ * \throws std::domain_error if the loglikelihood is not finite at init
+ */
+fit_result run_bounded_quasi_newton(
+    const std::vector<guts_native_data >& data,
+    const parameter_bounds& bounds,
+    const std::vector<double >& init,
+    const quasi_newton_settings& settings,
+    const std::size_t n_threads
+);
+
+/**
+ * \brief Settings of profile likelihoods
+ * \details
+ *   - LL_drop: the confidence region contains values whose profile loglikelihood is
+ *     within LL_drop of the maximum (qchisq(level, 1) / 2)
+ *   - max_steps: maximum number of grid steps from the estimate in each direction
+ *   - fit: settings of the conditional fits
+ */
+struct profile_settings {
+  double LL_drop;
+  std::size_t max_steps;
+  quasi_newton_settings fit;
+};
+
+/**
+ * \brief Profile likelihood of a parameter
+ * \details value and LL are sorted by value and include the estimate; par is the n x d matrix
+ * (column-major) of the conditional maximum likelihood estimates.
+ * lower and upper are the confidence bounds, interpolated linearly between grid values. A confidence
+ * bound is the parameter bound if the profile stays above the threshold up to the parameter bound,
+ * and NaN if the threshold is not reached within max_steps.
+ */
+struct profile_curve {
+  std::size_t which;
+  std::vector<double > value;
+  std::vector<double > LL;
+  std::vector<double > par;
+  double lower;
+  double upper;
+  std::size_t n_projection;
+};
+
+/**
+ * \brief Profile likelihoods and confidence intervals of parameters
+ * \details For each profiled parameter, a grid walks from the estimate towards lower and upper
+ * values with constant steps until the profile loglikelihood drops below LL_max - LL_drop.
+ * At each grid value, the other parameters are fitted (run_bounded_quasi_newton) starting
+ * from the conditional estimate of the neighbouring grid value. The walks (two per parameter)
+ * run in parallel; remaining threads parallelize the gradients of the fits.
+ * If the dominant rate constant is profiled, damage is calculated once per grid value
+ * (see guts_projector::set_start_conditions).
+ * \param[in] estimate maximum likelihood estimate
+ * \param[in] LL_max loglikelihood at estimate
+ * \param[in] which indices of the profiled parameters
+ * \param[in] step grid step of each parameter (positive)
+ */
+std::vector<profile_curve > run_profile_likelihood(
+    const std::vector<guts_native_data >& data,
+    const parameter_bounds& bounds,
+    const std::vector<double >& estimate,
+    const double LL_max,
+    const std::vector<std::size_t >& which,
+    const std::vector<double >& step,
+    const profile_settings& settings,
+    const std::size_t n_threads
+);
+
+/**
+ * \brief Settings of differential evolution
+ * \details
+ *   - n_pop: population size (>= 4)
+ *   - max_gen: maximum number of generations
+ *   - F: differential weight, in (0, 2]
+ *   - CR: crossover probability, in [0, 1]
+ *   - reltol: stop if the loglikelihood of all members is within reltol (|LL| + reltol) of the best
+ */
+struct differential_evolution_settings {
+  std::size_t n_pop;
+  std::size_t max_gen;
+  double F;
+  double CR;
+  double reltol;
+};
+
+/**
+ * \brief Result of differential evolution
+ * \details population is a n_pop x d matrix (column-major).
+ * convergence: 0 (stopped by reltol), 1 (max_gen reached).
+ */
+struct differential_evolution_result {
+  std::vector<double > par;
+  double LL;
+  std::vector<double > population;
+  std::vector<double > population_LL;
+  std::size_t generations;
+  std::size_t n_projection;
+  std::size_t rejected_early;
+  int convergence;
+  std::string message;
+};
+
+/**
+ * \brief Maximize the joint loglikelihood of data sets within finite box constraints by differential evolution
+ * \details DE/rand/1/bin (Storn & Price 1997, J Global Optim 11:341-359): each member x_i competes with the
+ * trial vector that takes the components of \f$ x_a + F (x_b - x_c) \f$ with probability CR (and at least one),
+ * where a, b, c are distinct random members other than i. Components outside bounds are set to the midpoint
+ * between x_i and the violated bound. A trial replaces x_i if its loglikelihood is at least as large; hence,
+ * its projection stops early below the loglikelihood of x_i.
+ * The initial population is uniform within bounds (the first member is init, if given).
+ * The trial vectors of a generation are drawn in the calling thread and evaluated in parallel,
+ * such that results do not depend on n_threads.
+ * \param[in] init initial member (empty: none)
+ * \throws std::invalid_argument if bounds are not finite or the population is too small
+ */
+differential_evolution_result run_differential_evolution(
+    const std::vector<guts_native_data >& data,
+    const parameter_bounds& bounds,
+    const std::vector<double >& init,
+    const differential_evolution_settings& settings,
+    const std::uint32_t seed,
+    const std::size_t n_threads
+);
+
+#endif //GUTS_OPTIM_H
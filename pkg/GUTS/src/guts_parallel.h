@@ -0,0 +1,152 @@
+/**
+ * GUTS: Fast Calculation of the Likelihood of a Stochastic Survival Model.
+ * soeren.vogel@posteo.ch, carlo.albert@eawag.ch, alexander singer@rifcon.de, oliver.jakoby@rifcon.de, dirk.nickisch@rifcon.de
+ * License GPL-2
+ * 2026-10-19
+ */
+
+#ifndef GUTS_PARALLEL_H
+#define GUTS_PARALLEL_H
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+/**
+ * \brief Call fun(i) for i = 0, ..., n-1 in up to n_threads threads
+ * \details Thread t calls fun(t), fun(t + n_threads), ...
+ * Workers must not call the R API. The first exception of a worker
+ * is rethrown in the calling thread after all workers joined.
+ * \param[in] n number of tasks
+ * \param[in] n_threads number of threads (<= 1: no threads are started)
+ * \param[in] fun callable with signature void(std::size_t)
+ */
+template<typename tFun >
+void parallel_for(const std::size_t n, std::size_t n_threads, tFun fun) {
+  if (n_threads > n) n_threads = n;
+  if (n_threads <= 1) {
+    for (std::size_t i = 0; i < n; ++i) fun(i);
+    return;
+  }
+  std::vector<std::exception_ptr > errors(n_threads);
+  std::vector<std::thread > workers;
+  workers.reserve(n_threads);
+  for (std::size_t t = 0; t < n_threads; ++t) {
+    workers.emplace_back([&, t]() {
+      try {
+        for (std::size_t i = t; i < n; i += n_threads) fun(i);
+      } catch (...) {
+        errors[t] = std::current_exception();
+      }
+    });
+  }
+  for (auto& w : workers) w.join();
+  for (auto& e : errors) {
+    if (e) std::rethrow_exception(e);
+  }
+}
+
+/**
+ * \brief Call fun(i, t) for i = 0, ..., n-1 in up to n_threads threads t, balanced by work stealing
+ * \details Thread t starts with the t-th contiguous block of tasks and calls them in order.
+ * A thread without tasks steals the second half of the remaining tasks of the thread with most
+ * remaining tasks. Hence, tasks of unequal cost are balanced; ordering tasks by decreasing cost
+ * helps. The thread of a task depends on timing: results must not depend on t, which only
+ * selects per-thread workspace. Workers must not call the R API. The first exception of a
+ * worker stops all workers and is rethrown in the calling thread after all workers joined.
+ * \param[in] n number of tasks
+ * \param[in] n_threads number of threads (<= 1: no threads are started)
+ * \param[in] fun callable with signature void(std::size_t i, std::size_t t)
+ */
+template<typename tFun >
+void parallel_for_stealing(const std::size_t n, std::size_t n_threads, tFun fun) {
+  if (n_threads > n) n_threads = n;
+  if (n_threads <= 1) {
+    for (std::size_t i = 0; i < n; ++i) fun(i, 0);
+    return;
+  }
+  struct task_range {
+    std::mutex lock;
+    std::size_t begin;
+    std::size_t end;
+  };
+  std::unique_ptr<task_range[] > ranges(new task_range[n_threads]);
+  for (std::size_t t = 0; t < n_threads; ++t) {
+    ranges[t].begin = t * n / n_threads;
+    ranges[t].end = (t + 1) * n / n_threads;
+  }
+  // moves half of the remaining tasks of the busiest thread to thread t; false if no tasks are left
+  auto steal = [&](const std::size_t t) {
+    while (true) {
+      std::size_t victim = t, max_remaining = 0;
+      for (std::size_t v = 0; v < n_threads; ++v) {
+        std::lock_guard<std::mutex > guard(ranges[v].lock);
+        if (ranges[v].end - ranges[v].begin > max_remaining) {
+          max_remaining = ranges[v].end - ranges[v].begin;
+          victim = v;
+        }
+      }
+      if (max_remaining == 0) return false;
+      std::size_t begin, end;
+      {
+        std::lock_guard<std::mutex > guard(ranges[victim].lock);
+        const std::size_t remaining = ranges[victim].end - ranges[victim].begin;
+        // the victim took tasks in the meantime
+        if (remaining == 0) continue;
+        end = ranges[victim].end;
+        begin = end - (remaining + 1) / 2;
+        ranges[victim].end = begin;
+      }
+      std::lock_guard<std::mutex > guard(ranges[t].lock);
+      ranges[t].begin = begin;
+      ranges[t].end = end;
+      return true;
+    }
+  };
+  std::atomic<bool > failed(false);
+  std::vector<std::exception_ptr > errors(n_threads);
+  std::vector<std::thread > workers;
+  workers.reserve(n_threads);
+  for (std::size_t t = 0; t < n_threads; ++t) {
+    workers.emplace_back([&, t]() {
+      try {
+        while (!failed) {
+          std::size_t i = n;
+          {
+            std::lock_guard<std::mutex > guard(ranges[t].lock);
+            if (ranges[t].begin < ranges[t].end) i = ranges[t].begin++;
+          }
+          if (i < n) {
+            fun(i, t);
+          } else if (!steal(t)) {
+            break;
+          }
+        }
+      } catch (...) {
+        errors[t] = std::current_exception();
+        failed = true;
+      }
+    });
+  }
+  for (auto& w : workers) w.join();
+  for (auto& e : errors) {
+    if (e) std::rethrow_exception(e);
+  }
+}
+
+/**
+ * \brief Random number engine of an independent stream
+ * \details Streams with the same seed but different stream numbers are
+ * seeded differently, e.g. one stream per chain or walker.
+ */
+inline std::mt19937_64 make_stream_rng(const std::uint32_t seed, const std::uint32_t stream) {
+  std::seed_seq seq{seed, stream, static_cast<std::uint32_t >(0x47555453)};
+  return std::mt19937_64(seq);
+}
+
+#endif //GUTS_PARALLEL_H
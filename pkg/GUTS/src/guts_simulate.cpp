@@ -0,0 +1,111 @@
+/**
+ * GUTS: Fast Calculation of the Likelihood of a Stochastic Survival Model.
+ * soeren.vogel@posteo.ch, carlo.albert@eawag.ch, alexander singer@rifcon.de, oliver.jakoby@rifcon.de, dirk.nickisch@rifcon.de
+ * License GPL-2
+ * 2026-10-19
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include "guts_parallel.h"
+#include "guts_simulate.h"
+
+std::vector<int > run_survivor_simulation(
+    const guts_native_data& data,
+    const std::vector<double >& par,
+    const std::size_t n,
+    const std::size_t n_rep,
+    const int n0,
+    const std::uint32_t seed,
+    const std::size_t n_threads
+) {
+  const std::size_t block_size = 1024;
+  const std::size_t d = n > 0 ? par.size() / n : 0;
+  const std::size_t n_t = data.yt.size();
+  const std::size_t n_rows = n * n_rep;
+  const std::size_t n_blocks = (n_rep + block_size - 1) / block_size;
+  const std::size_t n_workers = std::max<std::size_t >(1, n_threads);
+  std::vector<int > y(n_rows * n_t, -1);
+
+  std::vector<std::unique_ptr<guts_evaluator > > evaluators(n_workers);
+  // survival of the last parameter set of each thread
+  std::vector<std::vector<double > > S(n_workers);
+  std::vector<std::size_t > current(n_workers, n);
+  std::vector<guts_status > status(n_workers);
+  parallel_for_stealing(n * n_blocks, n_threads, [&](const std::size_t task, const std::size_t t) {
+    const std::size_t i = task / n_blocks;
+    if (current[t] != i) {
+      if (!evaluators[t]) evaluators[t] = make_guts_evaluator(data);
+      std::vector<double > q(d);
+      for (std::size_t j = 0; j < d; ++j) q[j] = par[i + j*n];
+      status[t] = evaluators[t]->calc_survival(q, S[t]);
+      current[t] = i;
+    }
+    if (status[t] != guts_status::ok) return;
+    std::mt19937_64 rng = make_stream_rng(seed, static_cast<std::uint32_t >(task));
+    std::vector<int > counts(n_t);
+    const std::size_t first = (task % n_blocks) * block_size;
+    for (std::size_t r = first; r < std::min(n_rep, first + block_size); ++r) {
+      simulate_survivors(S[t], n0, rng, counts.data());
+      const std::size_t row = r + n_rep * i;
+      for (std::size_t k = 0; k < n_t; ++k) y[row + n_rows * k] = counts[k];
+    }
+  });
+  return y;
+}
+
+predictive_bands run_predictive_bands(
+    const guts_native_data& data,
+    const std::vector<double >& par,
+    const std::size_t n,
+    const std::vector<double >& probs,
+    const double compression,
+    const std::size_t n_threads
+) {
+  const std::size_t d = n > 0 ? par.size() / n : 0;
+  const std::size_t n_t = data.yt.size();
+  const std::size_t n_workers = std::max<std::size_t >(1, std::min(n_threads, n));
+  std::vector<std::vector<t_digest > > sketches(n_workers, std::vector<t_digest >(n_t, t_digest(compression)));
+  // sums of survival with Kahan compensation
+  std::vector<std::vector<double > > sums(n_workers, std::vector<double >(n_t, 0.0));
+  std::vector<std::vector<double > > compensation(n_workers, std::vector<double >(n_t, 0.0));
+  std::vector<std::size_t > failed(n_workers, 0);
+  std::vector<std::unique_ptr<guts_evaluator > > evaluators(n_workers);
+  for (auto& evaluator : evaluators) evaluator = make_guts_evaluator(data);
+  // task i always runs in thread i % n_workers, see parallel_for
+  parallel_for(n, n_workers, [&](const std::size_t i) {
+    const std::size_t t = i % n_workers;
+    std::vector<double > q(d), S;
+    for (std::size_t j = 0; j < d; ++j) q[j] = par[i + j*n];
+    if (evaluators[t]->calc_survival(q, S) != guts_status::ok) {
+      ++failed[t];
+      return;
+    }
+    for (std::size_t k = 0; k < n_t; ++k) {
+      sketches[t][k].add(S[k]);
+      const double y = S[k] - compensation[t][k];
+      const double sum = sums[t][k] + y;
+      compensation[t][k] = (sum - sums[t][k]) - y;
+      sums[t][k] = sum;
+    }
+  });
+
+  predictive_bands bands;
+  bands.n_failed = 0;
+  for (std::size_t t = 0; t < n_workers; ++t) bands.n_failed += failed[t];
+  const double n_ok = static_cast<double >(n - bands.n_failed);
+  bands.mean.assign(n_t, std::numeric_limits<double >::quiet_NaN());
+  bands.quantile.assign(n_t * probs.size(), std::numeric_limits<double >::quiet_NaN());
+  for (std::size_t k = 0; k < n_t; ++k) {
+    for (std::size_t t = 1; t < n_workers; ++t) sketches[0][k].merge(sketches[t][k]);
+    if (n_ok > 0) {
+      double sum = 0.0;
+      for (std::size_t t = 0; t < n_workers; ++t) sum += sums[t][k];
+      bands.mean[k] = sum / n_ok;
+    }
+    for (std::size_t j = 0; j < probs.size(); ++j) bands.quantile[k + n_t * j] = sketches[0][k].quantile(probs[j]);
+  }
+  return bands;
+}
@@ -0,0 +1,88 @@
+/**
+ * GUTS: Fast Calculation of the Likelihood of a Stochastic Survival Model.
+ * soeren.vogel@posteo.ch, carlo.albert@eawag.ch, alexander singer@rifcon.de, oliver.jakoby@rifcon.de, dirk.nickisch@rifcon.de
+ * License GPL-2
+ * 2026-10-19
+ */
+
+#ifndef GUTS_SIMULATE_H
+#define GUTS_SIMULATE_H
+
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "guts_native.h"
+#include "guts_sketch.h"
+
+/**
+ * \brief Draw survivor counts from survival probabilities
+ * \details Conditional binomial draws between survival times:
+ * \f$ y_k \sim Binomial(y_{k-1}, S_k / S_{k-1}) \f$, with \f$ y_0 \f$ = n0.
+ * \param[in] S survival probabilities at the survival times, S[0] = 1
+ * \param[out] y survivor counts at the survival times
+ */
+template<typename tRNG >
+void simulate_survivors(const std::vector<double >& S, const int n0, tRNG& rng, int* y) {
+  y[0] = n0;
+  for (std::size_t k = 1; k < S.size(); ++k) {
+    double q = S[k-1] > 0.0 ? S[k] / S[k-1] : 0.0;
+    if (!(q > 0.0)) q = 0.0;
+    if (q > 1.0) q = 1.0;
+    std::binomial_distribution<int > rbinom(y[k-1], q);
+    y[k] = rbinom(rng);
+  }
+}
+
+/**
+ * \brief Survivor counts of virtual experiments with the design of a data set
+ * \details Survival is projected once per parameter set (see guts_evaluator::calc_survival).
+ * Replicates are drawn in blocks; block b of parameter set i uses the random stream
+ * make_stream_rng(seed, i * n_blocks + b). Hence, counts do not depend on n_threads.
+ * Blocks are distributed by parallel_for_stealing; a thread keeps the projection of its last
+ * parameter set.
+ * \param[in] par n x d matrix of parameters (column-major)
+ * \param[in] n_rep number of replicates per parameter set
+ * \param[in] n0 number of individuals at the first survival time
+ * \returns (n n_rep) x length(yt) matrix of survivor counts (column-major); row r + n_rep i is
+ * replicate r of parameter set i; -1 for invalid parameters
+ */
+std::vector<int > run_survivor_simulation(
+    const guts_native_data& data,
+    const std::vector<double >& par,
+    const std::size_t n,
+    const std::size_t n_rep,
+    const int n0,
+    const std::uint32_t seed,
+    const std::size_t n_threads
+);
+
+/**
+ * \brief Posterior predictive bands of survival
+ * \details mean: length(yt) mean survival; quantile: length(yt) x length(probs) matrix (column-major);
+ * n_failed: number of parameter sets with failed projections (not included).
+ */
+struct predictive_bands {
+  std::vector<double > mean;
+  std::vector<double > quantile;
+  std::size_t n_failed;
+};
+
+/**
+ * \brief Quantiles of survival at the survival times over parameter samples, without storing projections
+ * \details Each thread projects a share of the parameter sets (see guts_evaluator::calc_survival) and
+ * feeds the survival at each survival time into a t_digest per survival time. The sketches of the
+ * threads are merged in thread order. Memory is O(n_threads length(yt) compression), independent of n.
+ * Quantiles are approximate (exact minimum and maximum); results depend on n_threads within this accuracy.
+ * \param[in] par n x d matrix of parameters (column-major)
+ * \param[in] probs probabilities of the quantiles, in [0, 1]
+ */
+predictive_bands run_predictive_bands(
+    const guts_native_data& data,
+    const std::vector<double >& par,
+    const std::size_t n,
+    const std::vector<double >& probs,
+    const double compression,
+    const std::size_t n_threads
+);
+
+#endif //GUTS_SIMULATE_H
@@ -0,0 +1,99 @@
+/**
+ * GUTS: Fast Calculation of the Likelihood of a Stochastic Survival Model.
+ * soeren.vogel@posteo.ch, carlo.albert@eawag.ch, alexander singer@rifcon.de, oliver.jakoby@rifcon.de, dirk.nickisch@rifcon.de
+ * License GPL-2
+ * 2026-10-19
+ */
+
+#include <cstring>
+#include <stdexcept>
+#include "guts_sink.h"
+
+namespace {
+
+const std::size_t header_size = 64;
+const std::size_t descriptor_size = 64;
+const std::size_t name_size = 48;
+const std::uint32_t file_version = 1;
+const std::uint32_t byte_order_mark = 0x01020304;
+// offset of the complete flag in the header
+const std::size_t complete_offset = 28;
+
+inline std::uint32_t column_width(const column_type type) {
+  return type == column_type::int32 ? 4 : 8;
+}
+
+template<typename T >
+inline void put(std::vector<char >& buffer, const std::size_t offset, const T value) {
+  std::memcpy(buffer.data() + offset, &value, sizeof(T));
+}
+
+} // namespace
+
+guts_result_sink::guts_result_sink(
+    const std::string& new_path,
+    const std::vector<std::string >& names,
+    const std::vector<column_type >& new_types,
+    const std::uint64_t new_n_rows
+) :
+  path(new_path), n_rows(new_n_rows), types(new_types), offsets(new_types.size())
+{
+  if (names.size() != types.size() || names.empty()) {
+    throw std::invalid_argument("Need one type per column and at least one column.");
+  }
+  std::vector<char > head(header_size + descriptor_size * types.size(), 0);
+  std::memcpy(head.data(), "GUTSCOLS", 8);
+  put(head, 8, file_version);
+  put(head, 12, byte_order_mark);
+  put(head, 16, n_rows);
+  put(head, 24, static_cast<std::uint32_t >(types.size()));
+  put(head, complete_offset, std::uint32_t(0));
+  std::uint64_t offset = head.size();
+  for (std::size_t j = 0; j < types.size(); ++j) {
+    if (names[j].size() >= name_size) throw std::invalid_argument("Column name too long: " + names[j]);
+    const std::size_t d = header_size + descriptor_size * j;
+    std::memcpy(head.data() + d, names[j].data(), names[j].size());
+    put(head, d + name_size, static_cast<std::uint32_t >(types[j]));
+    put(head, d + name_size + 4, column_width(types[j]));
+    put(head, d + name_size + 8, offset);
+    offsets[j] = offset;
+    // align the next column to 8 bytes
+    offset += (column_width(types[j]) * n_rows + 7) / 8 * 8;
+  }
+  file.open(path, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!file) throw std::runtime_error("Cannot create result file " + path);
+  file.write(head.data(), head.size());
+  // allocate the columns
+  if (offset > head.size()) {
+    file.seekp(offset - 1);
+    file.put('\0');
+  }
+  if (!file) throw std::runtime_error("Cannot write result file " + path);
+}
+
+void guts_result_sink::write(const std::size_t column, const std::uint64_t first_row, const double* values, const std::size_t count) {
+  write_at(column, first_row, column_type::float64, reinterpret_cast<const char* >(values), count);
+}
+
+void guts_result_sink::write(const std::size_t column, const std::uint64_t first_row, const std::int32_t* values, const std::size_t count) {
+  write_at(column, first_row, column_type::int32, reinterpret_cast<const char* >(values), count);
+}
+
+void guts_result_sink::write_at(const std::size_t column, const std::uint64_t first_row, const column_type type, const char* values, const std::size_t count) {
+  if (column >= types.size() || types[column] != type) throw std::invalid_argument("Wrong column or column type.");
+  if (first_row + count > n_rows) throw std::invalid_argument("Rows out of range.");
+  if (count == 0) return;
+  std::lock_guard<std::mutex > guard(lock);
+  file.seekp(offsets[column] + first_row * column_width(type));
+  file.write(values, count * column_width(type));
+  if (!file) throw std::runtime_error("Cannot write result file " + path);
+}
+
+void guts_result_sink::finish() {
+  std::lock_guard<std::mutex > guard(lock);
+  const std::uint32_t complete = 1;
+  file.seekp(complete_offset);
+  file.write(reinterpret_cast<const char* >(&complete), sizeof(complete));
+  file.close();
+  if (file.fail()) throw std::runtime_error("Cannot write result file " + path);
+}
@@ -0,0 +1,76 @@
+/**
+ * GUTS: Fast Calculation of the Likelihood of a Stochastic Survival Model.
+ * soeren.vogel@posteo.ch, carlo.albert@eawag.ch, alexander singer@rifcon.de, oliver.jakoby@rifcon.de, dirk.nickisch@rifcon.de
+ * License GPL-2
+ * 2026-10-19
+ */
+
+#ifndef GUTS_SINK_H
+#define GUTS_SINK_H
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * \brief Types of result columns
+ */
+enum class column_type : std::uint32_t {
+  float64 = 0,
+  int32 = 1
+};
+
+/**
+ * \brief Columnar binary file of results, written in chunks by worker threads
+ * \details The file has a fixed number of rows and typed columns. Layout (native byte order,
+ * recorded by the byte order mark):
+ *   - header, 64 bytes: magic "GUTSCOLS" (8), version (uint32), byte order mark 0x01020304 (uint32),
+ *     number of rows (uint64), number of columns (uint32), complete flag (uint32), zero padding
+ *   - one descriptor per column, 64 bytes: name (48, zero padded), type (uint32),
+ *     width in bytes (uint32), offset of the column data (uint64)
+ *   - the column data, each column contiguous and aligned to 8 bytes
+ * Hence, a column is a plain array that can be memory-mapped, and a chunk of rows
+ * of a column is a single positioned write. The complete flag is set by finish() only,
+ * such that files of interrupted runs can be recognized.
+ * write() and finish() are thread-safe.
+ */
+class guts_result_sink {
+public:
+  /**
+   * \param[in] path file name; an existing file is replaced
+   * \param[in] names column names (at most 47 characters)
+   * \param[in] types column types
+   * \param[in] n_rows number of rows
+   * \throws std::invalid_argument for invalid columns, std::runtime_error if the file cannot be written
+   */
+  guts_result_sink(
+      const std::string& path,
+      const std::vector<std::string >& names,
+      const std::vector<column_type >& types,
+      const std::uint64_t n_rows
+  );
+  /**
+   * \brief Write values to rows first_row, ..., first_row + count - 1 of a column
+   * \throws std::invalid_argument if the column type does not match or rows are out of range,
+   * std::runtime_error if the file cannot be written
+   */
+  void write(const std::size_t column, const std::uint64_t first_row, const double* values, const std::size_t count);
+  void write(const std::size_t column, const std::uint64_t first_row, const std::int32_t* values, const std::size_t count);
+  /**
+   * \brief Set the complete flag and close the file
+   */
+  void finish();
+  std::uint64_t get_n_rows() const {return n_rows;}
+private:
+  std::mutex lock;
+  std::fstream file;
+  const std::string path;
+  const std::uint64_t n_rows;
+  std::vector<column_type > types;
+  std::vector<std::uint64_t > offsets;
+  void write_at(const std::size_t column, const std::uint64_t first_row, const column_type type, const char* values, const std::size_t count);
+};
+
+#endif //GUTS_SINK_H
@@ -0,0 +1,96 @@
+/**
+ * GUTS: Fast Calculation of the Likelihood of a Stochastic Survival Model.
+ * soeren.vogel@posteo.ch, carlo.albert@eawag.ch, alexander singer@rifcon.de, oliver.jakoby@rifcon.de, dirk.nickisch@rifcon.de
+ * License GPL-2
+ * 2026-10-19
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "guts_sketch.h"
+
+namespace {
+
+const double pi = 3.14159265358979323846;
+
+} // namespace
+
+t_digest::t_digest(const double new_compression) :
+  compression(new_compression), total(0.0), buffered(0.0),
+  min(std::numeric_limits<double >::infinity()), max(-std::numeric_limits<double >::infinity())
+{
+  buffer.reserve(static_cast<std::size_t >(5.0 * compression));
+}
+
+void t_digest::add(const double x, const double w) {
+  if (std::isnan(x) || !(w > 0.0)) return;
+  buffer.push_back({x, w});
+  buffered += w;
+  min = std::min(min, x);
+  max = std::max(max, x);
+  if (buffer.size() >= static_cast<std::size_t >(5.0 * compression)) compress();
+}
+
+void t_digest::merge(const t_digest& other) {
+  other.compress();
+  for (const centroid& c : other.centroids) buffer.push_back(c);
+  buffered += other.total;
+  min = std::min(min, other.min);
+  max = std::max(max, other.max);
+  compress();
+}
+
+void t_digest::compress() const {
+  if (buffer.empty()) return;
+  buffer.insert(buffer.end(), centroids.begin(), centroids.end());
+  std::sort(buffer.begin(), buffer.end(), [](const centroid& a, const centroid& b) {return a.mean < b.mean;});
+  total += buffered;
+  buffered = 0.0;
+  // largest quantile of the centroid that starts at q0: k^{-1}(k(q0) + 1)
+  auto q_limit = [this](const double q0) {
+    const double k = compression / (2.0 * pi) * std::asin(2.0 * q0 - 1.0) + 1.0;
+    return k >= compression / 4.0 ? 1.0 : 0.5 * (std::sin(2.0 * pi * k / compression) + 1.0);
+  };
+  centroids.clear();
+  centroid current = buffer.front();
+  double q0 = 0.0;
+  double limit = q_limit(q0);
+  for (std::size_t i = 1; i < buffer.size(); ++i) {
+    const double q = q0 + (current.weight + buffer[i].weight) / total;
+    if (q <= limit) {
+      current.weight += buffer[i].weight;
+      current.mean += (buffer[i].mean - current.mean) * buffer[i].weight / current.weight;
+    } else {
+      centroids.push_back(current);
+      q0 += current.weight / total;
+      limit = q_limit(q0);
+      current = buffer[i];
+    }
+  }
+  centroids.push_back(current);
+  buffer.clear();
+}
+
+double t_digest::quantile(const double q) const {
+  compress();
+  if (centroids.empty() || std::isnan(q)) return std::numeric_limits<double >::quiet_NaN();
+  if (q <= 0.0) return min;
+  if (q >= 1.0) return max;
+  const double index = q * total;
+  // the first and last half centroids interpolate to the minimum and maximum
+  const centroid& first = centroids.front();
+  if (index < first.weight / 2.0) {
+    return min + (first.mean - min) * index / (first.weight / 2.0);
+  }
+  double cumulative = first.weight / 2.0;
+  for (std::size_t i = 0; i + 1 < centroids.size(); ++i) {
+    const double step = (centroids[i].weight + centroids[i+1].weight) / 2.0;
+    if (index < cumulative + step) {
+      return centroids[i].mean + (centroids[i+1].mean - centroids[i].mean) * (index - cumulative) / step;
+    }
+    cumulative += step;
+  }
+  const centroid& last = centroids.back();
+  return last.mean + (max - last.mean) * (index - cumulative) / (last.weight / 2.0);
+}
@@ -0,0 +1,57 @@
+/**
+ * GUTS: Fast Calculation of the Likelihood of a Stochastic Survival Model.
+ * soeren.vogel@posteo.ch, carlo.albert@eawag.ch, alexander singer@rifcon.de, oliver.jakoby@rifcon.de, dirk.nickisch@rifcon.de
+ * License GPL-2
+ * 2026-10-19
+ */
+
+#ifndef GUTS_SKETCH_H
+#define GUTS_SKETCH_H
+
+#include <vector>
+
+/**
+ * \brief Mergeable streaming quantile sketch (merging t-digest)
+ * \details Dunning & Ertl (2019), Computing extremely accurate quantiles using t-digests,
+ * arXiv:1902.04023. Values are buffered and merged into weighted centroids whose sizes are
+ * limited by the scale function \f$ k(q) = \delta / (2 \pi) \arcsin(2 q - 1) \f$; hence,
+ * centroids are small in the tails and quantiles near 0 and 1 are accurate.
+ * Memory is O(compression) independent of the number of values. Quantiles interpolate
+ * linearly between centroids and use the exact minimum and maximum.
+ * Sketches of parts of a sample can be merged.
+ */
+class t_digest {
+public:
+  /**
+   * \param[in] new_compression \f$ \delta \f$; about compression / 2 centroids are kept
+   */
+  explicit t_digest(const double new_compression = 200.0);
+  /**
+   * \brief add value x with weight w; NaN is ignored
+   */
+  void add(const double x, const double w = 1.0);
+  void merge(const t_digest& other);
+  /**
+   * \returns the q-quantile (q in [0, 1]); NaN if the sketch is empty
+   */
+  double quantile(const double q) const;
+  double get_count() const {return total + buffered;}
+  double get_min() const {return min;}
+  double get_max() const {return max;}
+private:
+  struct centroid {
+    double mean;
+    double weight;
+  };
+  double compression;
+  mutable std::vector<centroid > centroids;
+  mutable std::vector<centroid > buffer;
+  mutable double total;
+  mutable double buffered;
+  double min;
+  double max;
+  // merge the buffer into the centroids
+  void compress() const;
+};
+
+#endif //GUTS_SKETCH_H